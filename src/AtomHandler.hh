@@ -30,6 +30,10 @@ class FluxboxWindow;
 class WinClient;
 class BScreen;
 
+namespace FbTk {
+class PropertyPrefetch;
+}
+
 class AtomHandler {
 public:
 
@@ -38,6 +42,8 @@ public:
     virtual void initForScreen(BScreen &screen) = 0;
     virtual void setupFrame(FluxboxWindow &win) = 0;
     virtual void setupClient(WinClient &winclient) = 0;
+    /// add the client properties that setupClient and setupFrame read
+    virtual void prefetchProperties(FbTk::PropertyPrefetch &prefetch) { }
 
     virtual void updateFocusedWindow(BScreen &screen, Window win) = 0;
     virtual void updateClientList(BScreen &screen) = 0;
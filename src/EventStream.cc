@@ -0,0 +1,192 @@
+// EventStream.cc for Fluxbox Window Manager
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "EventStream.hh"
+
+#include "RemoteControl.hh"
+#include "Screen.hh"
+#include "Window.hh"
+#include "WinClient.hh"
+#include "Workspace.hh"
+
+#include "FbTk/MemFun.hh"
+
+#include <sstream>
+#include <cstdio>
+
+using std::string;
+
+namespace {
+
+/// @return @a str as a quoted json string
+string quote(const string &str) {
+    string ret("\"");
+    for (string::const_iterator it = str.begin(); it != str.end(); ++it) {
+        switch (*it) {
+        case '"':
+            ret += "\\\"";
+            break;
+        case '\\':
+            ret += "\\\\";
+            break;
+        case '\n':
+            ret += "\\n";
+            break;
+        case '\t':
+            ret += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(*it) < 0x20) {
+                char buf[8];
+                sprintf(buf, "\\u%04x", static_cast<unsigned char>(*it));
+                ret += buf;
+            } else
+                ret += *it;
+            break;
+        }
+    }
+    return ret + "\"";
+}
+
+const char *boolean(bool value) {
+    return value ? "true" : "false";
+}
+
+} // end anonymous namespace
+
+EventStream::EventStream(RemoteControl &remote):
+    m_remote(remote) {
+    setName("eventstream");
+}
+
+void EventStream::setupClient(WinClient &winclient) {
+    join(winclient.titleSig(), FbTk::MemFun(*this, &EventStream::titleChanged));
+}
+
+void EventStream::updateFocusedWindow(BScreen &screen, Window win) {
+    if (!m_remote.hasSubscribers("focus"))
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"screen\":"<<screen.screenNumber()<<",\"window\":"<<win;
+    publish("focus", fields.str());
+}
+
+void EventStream::updateClientList(BScreen &screen) {
+    if (!m_remote.hasSubscribers("clientlist"))
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"screen\":"<<screen.screenNumber();
+    publish("clientlist", fields.str());
+}
+
+void EventStream::updateWorkspaceNames(BScreen &screen) {
+    if (!m_remote.hasSubscribers("workspacenames"))
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"screen\":"<<screen.screenNumber()<<",\"names\":[";
+    const BScreen::WorkspaceNames &names = screen.getWorkspaceNames();
+    for (size_t i = 0; i < names.size(); ++i)
+        fields<<(i ? "," : "")<<quote(names[i]);
+    fields<<"]";
+    publish("workspacenames", fields.str());
+}
+
+void EventStream::updateCurrentWorkspace(BScreen &screen) {
+    if (!m_remote.hasSubscribers("workspace") || !screen.currentWorkspace())
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"screen\":"<<screen.screenNumber()
+          <<",\"workspace\":"<<screen.currentWorkspaceID()
+          <<",\"name\":"<<quote(screen.currentWorkspace()->name());
+    publish("workspace", fields.str());
+}
+
+void EventStream::updateWorkspaceCount(BScreen &screen) {
+    if (!m_remote.hasSubscribers("workspacecount"))
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"screen\":"<<screen.screenNumber()
+          <<",\"count\":"<<screen.numberOfWorkspaces();
+    publish("workspacecount", fields.str());
+}
+
+void EventStream::updateClientClose(WinClient &winclient) {
+    if (!m_remote.hasSubscribers("close"))
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"window\":"<<winclient.window();
+    publish("close", fields.str());
+}
+
+void EventStream::updateWorkspace(FluxboxWindow &win) {
+    if (!m_remote.hasSubscribers("windowworkspace") || !win.winClient().window())
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"window\":"<<win.winClient().window()
+          <<",\"workspace\":"<<win.workspaceNumber();
+    publish("windowworkspace", fields.str());
+}
+
+void EventStream::updateState(FluxboxWindow &win) {
+    if (!m_remote.hasSubscribers("state"))
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"window\":"<<win.winClient().window()
+          <<",\"iconic\":"<<boolean(win.isIconic())
+          <<",\"shaded\":"<<boolean(win.isShaded())
+          <<",\"stuck\":"<<boolean(win.isStuck())
+          <<",\"maximized\":"<<boolean(win.isMaximized())
+          <<",\"fullscreen\":"<<boolean(win.isFullscreen());
+    publish("state", fields.str());
+}
+
+void EventStream::updateLayer(FluxboxWindow &win) {
+    if (!m_remote.hasSubscribers("layer"))
+        return;
+
+    std::ostringstream fields;
+    fields<<"\"window\":"<<win.winClient().window()
+          <<",\"layer\":"<<win.layerNum();
+    publish("layer", fields.str());
+}
+
+void EventStream::titleChanged(const string &title, Focusable &win) {
+    if (!m_remote.hasSubscribers("title"))
+        return;
+
+    WinClient *client = dynamic_cast<WinClient *>(&win);
+    std::ostringstream fields;
+    fields<<"\"window\":"<<(client ? client->window() : 0)
+          <<",\"title\":"<<quote(title);
+    publish("title", fields.str());
+}
+
+void EventStream::publish(const char *event, const string &fields) {
+    m_remote.publish(event, string("\"event\":\"") + event + "\"," + fields);
+}
@@ -0,0 +1,83 @@
+// EventStream.hh for Fluxbox Window Manager
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef EVENTSTREAM_HH
+#define EVENTSTREAM_HH
+
+#include "AtomHandler.hh"
+
+#include "FbTk/Signal.hh"
+
+#include <string>
+
+class RemoteControl;
+class Focusable;
+
+/// Forwards window manager events to RemoteControl subscribers
+/**
+ * Every event is one line of JSON, e.g.
+ *   {"seq":12,"event":"workspace","screen":0,"workspace":1,"name":"two"}
+ * "seq" counts up by one for every event sent to that client, so it can
+ * tell whether it missed any, no matter which events it subscribed to. The events are:
+ *   focus, workspace, workspacenames, workspacecount, clientlist,
+ *   title, state, windowworkspace, layer and close
+ * Nothing is formatted unless somebody subscribed to the event.
+ */
+class EventStream: public AtomHandler, private FbTk::SignalTracker {
+public:
+    explicit EventStream(RemoteControl &remote);
+
+    void initForScreen(BScreen &screen) { }
+    void setupFrame(FluxboxWindow &win) { }
+    void setupClient(WinClient &winclient);
+
+    void updateFocusedWindow(BScreen &screen, Window win);
+    void updateClientList(BScreen &screen);
+    void updateWorkspaceNames(BScreen &screen);
+    void updateCurrentWorkspace(BScreen &screen);
+    void updateWorkspaceCount(BScreen &screen);
+    void updateWorkarea(BScreen &screen) { }
+
+    void updateFrameClose(FluxboxWindow &win) { }
+    void updateClientClose(WinClient &winclient);
+    void updateWorkspace(FluxboxWindow &win);
+    void updateState(FluxboxWindow &win);
+    void updateHints(FluxboxWindow &win) { }
+    void updateLayer(FluxboxWindow &win);
+
+    bool checkClientMessage(const XClientMessageEvent &ce,
+                            BScreen * screen, WinClient * const winclient) {
+        return false;
+    }
+    bool propertyNotify(WinClient &winclient, Atom the_property) {
+        return false;
+    }
+
+private:
+    void titleChanged(const std::string &title, Focusable &win);
+
+    /// sends @a fields (already formatted json members) as @a event
+    void publish(const char *event, const std::string &fields);
+
+    RemoteControl &m_remote;
+};
+
+#endif // EVENTSTREAM_HH
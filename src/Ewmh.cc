@@ -33,6 +33,7 @@
 
 #include "FbTk/App.hh"
 #include "FbTk/FbWindow.hh"
+#include "FbTk/PropertyPrefetch.hh"
 #include "FbTk/I18n.hh"
 #include "FbTk/LayerItem.hh"
 #include "FbTk/Layer.hh"
@@ -703,6 +704,15 @@ void Ewmh::setupClient(WinClient &winclient) {
 
 }
 
+void Ewmh::prefetchProperties(FbTk::PropertyPrefetch &prefetch) {
+    prefetch.add(m_net->wm_name);
+    prefetch.add(m_net->wm_icon);
+    prefetch.add(m_net->wm_window_type);
+    prefetch.add(m_net->wm_strut);
+    prefetch.add(m_net->wm_state);
+    prefetch.add(m_net->wm_desktop);
+}
+
 void Ewmh::setupFrame(FluxboxWindow &win) {
     setupState(win);
     bool exists;
@@ -1290,11 +1300,7 @@ bool Ewmh::propertyNotify(WinClient &winclient, Atom the_property) {
         updateStrut(winclient);
         return true;
     } else if (the_property == m_net->wm_name) {
-        FbTk::FbString newtitle = winclient.textProperty(the_property);
-        if (!newtitle.empty())
-            winclient.setTitle(newtitle);
-        if (winclient.fbwindow())
-            winclient.fbwindow()->titleSig().emit(newtitle, *winclient.fbwindow());
+        winclient.scheduleTitleUpdate(the_property);
         return true;
     } else if (the_property == m_net->wm_icon_name) {
         // we don't use icon title, since we don't show icons
@@ -32,6 +32,7 @@ public:
     void initForScreen(BScreen &screen);
     void setupFrame(FluxboxWindow &win);
     void setupClient(WinClient &winclient);
+    void prefetchProperties(FbTk::PropertyPrefetch &prefetch);
 
     void updateFocusedWindow(BScreen &screen, Window win);
     void updateClientList(BScreen &screen);
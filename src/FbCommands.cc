@@ -68,6 +68,7 @@ using std::pair;
 using std::set;
 using std::ofstream;
 using std::endl;
+using std::cerr;
 using std::ios;
 
 namespace {
@@ -234,6 +235,12 @@ void RestartFluxboxCmd::execute() {
     Fluxbox::instance()->restart(m_cmd.c_str());
 }
 
+REGISTER_COMMAND(dumpstats, FbCommands::DumpStatsCmd, void);
+
+void DumpStatsCmd::execute() {
+    Fluxbox::instance()->dumpStats(cerr);
+}
+
 REGISTER_COMMAND(reconfigure, FbCommands::ReconfigureFluxboxCmd, void);
 REGISTER_COMMAND(reconfig, FbCommands::ReconfigureFluxboxCmd, void);
 
@@ -83,6 +83,12 @@ private:
     std::string m_cmd;
 };
 
+/// writes statistics, like startup and event handling times, to stderr
+class DumpStatsCmd: public FbTk::Command<void> {
+public:
+    void execute();
+};
+
 /// reconfigures fluxbox
 class ReconfigureFluxboxCmd: public FbTk::Command<void> {
 public:
@@ -75,6 +75,7 @@ App::~App() {
     if (m_display != 0) {
 
         Font::shutdown();
+        Image::clearCache();
 
         XCloseDisplay(m_display);
         m_display = 0;
@@ -23,9 +23,11 @@
 #define CommandParser_HH
 
 #include "StringUtil.hh"
+#include "RefCount.hh"
 
 #include <string>
 #include <map>
+#include <list>
 
 using std::string;
 
@@ -80,6 +82,9 @@ public:
     typedef Command<Type> *(*Creator)(const string &, const string &, bool);
     typedef std::map<std::string, Creator> CreatorMap;
 
+    /// maximum number of commands kept by parseCached()
+    enum { CACHE_SIZE = 64 };
+
     static CommandParser<Type> &instance() {
         static CommandParser<Type> s_instance;
         return s_instance;
@@ -105,9 +110,36 @@ public:
         return parse(command, args, trusted);
     }
 
+    /**
+     * Same as parse(line, trusted), but the resulting command is kept in a
+     * small LRU cache keyed by the raw line, so a line that is sent over and
+     * over again (e.g. through fluxbox-remote) is only parsed once.
+     * The returned command is shared, so only use this for callers that
+     * execute the command right away instead of holding on to it.
+     */
+    RefCount<Command<Type> > parseCached(const string &line, bool trusted = true) {
+        const CacheKey key(line, trusted);
+        typename CacheIndex::iterator it = m_cache_index.find(key);
+        if (it != m_cache_index.end()) {
+            // move to front, it is the most recently used one now
+            m_cache.splice(m_cache.begin(), m_cache, it->second);
+            return it->second->second;
+        }
+
+        RefCount<Command<Type> > cmd(parse(line, trusted));
+        m_cache.push_front(std::make_pair(key, cmd));
+        m_cache_index[key] = m_cache.begin();
+        if (m_cache.size() > CACHE_SIZE) {
+            m_cache_index.erase(m_cache.back().first);
+            m_cache.pop_back();
+        }
+        return cmd;
+    }
+
     bool registerCommand(string name, Creator creator) {
         name = StringUtil::toLower(name);
         m_creators[name] = creator;
+        clearCache();
         return true;
     }
 
@@ -118,13 +150,25 @@ public:
         return it->second;
     }
 
+    void clearCache() {
+        m_cache.clear();
+        m_cache_index.clear();
+    }
+
+    /// sorted list of all creators
     const CreatorMap &creatorMap() const { return m_creators; }
 
 private:
     CommandParser() {}
     ~CommandParser() {}
 
+    typedef std::pair<std::string, bool> CacheKey;
+    typedef std::list<std::pair<CacheKey, RefCount<Command<Type> > > > CacheList;
+    typedef std::map<CacheKey, typename CacheList::iterator> CacheIndex;
+
     CreatorMap m_creators;
+    CacheList m_cache; ///< parsed commands, most recently used first
+    CacheIndex m_cache_index;
 };
 
 } // end namespace FbTk
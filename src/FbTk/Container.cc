@@ -168,6 +168,7 @@ bool Container::removeItem(Item item) {
         return false;
 
     m_item_list.erase(it);
+    m_repositioned.remove(item);
     repositionItems();
     return true;
 }
@@ -180,6 +181,7 @@ bool Container::removeItem(int index) {
     for (; index != 0; ++it, --index)
         continue;
 
+    m_repositioned.remove(*it);
     m_item_list.erase(it);
 
     repositionItems();
@@ -188,6 +190,7 @@ bool Container::removeItem(int index) {
 
 void Container::removeAll() {
     m_item_list.clear();
+    m_repositioned.clear();
     if (!m_update_lock) {
         clear();
     }
@@ -291,7 +294,11 @@ bool Container::tryButtonReleaseEvent(XButtonEvent &event) {
 }
 
 void Container::repositionItems() {
-    if (empty() || m_update_lock)
+    if (m_update_lock)
+        return;
+
+    m_repositioned.clear();
+    if (empty())
         return;
 
     /**
@@ -398,9 +405,16 @@ void Container::repositionItems() {
         translatePosition(m_orientation, tmpx, tmpy, tmpw, tmph, borderW);
         translateSize(m_orientation, tmpw, tmph);
 
+        // only items that actually change get touched, so
+        // adding or removing one doesn't redraw all of them
+        if ((*it)->x() == tmpx && (*it)->y() == tmpy &&
+            (*it)->width() == tmpw && (*it)->height() == tmph)
+            continue;
+
         // resize each clients including border in size
         (*it)->moveResize(tmpx, tmpy,
                           tmpw, tmph);
+        m_repositioned.push_back(*it);
 
         // moveresize does a clear
     }
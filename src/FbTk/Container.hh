@@ -89,6 +89,8 @@ public:
     bool empty() const { return m_item_list.empty(); }
     unsigned int maxWidthPerClient() const;
     bool updateLock() const { return m_update_lock; }
+    /// the items that got moved or resized by the last layout
+    const ItemList &repositionedItems() const { return m_repositioned; }
 
     void for_each(std::mem_fun_t<void, FbWindow> function);
     void setAlpha(int alpha); // set alpha on all windows
@@ -107,6 +109,7 @@ private:
     unsigned int m_max_size_per_client;
     unsigned int m_max_total_size;
     ItemList m_item_list;
+    ItemList m_repositioned;
     bool m_update_lock, m_auto_resize;
 };
 
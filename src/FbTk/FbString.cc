@@ -49,6 +49,7 @@
 
 #include <iostream>
 #include <vector>
+#include <map>
 
 #ifndef HAVE_ICONV
 typedef int iconv_t;
@@ -68,38 +69,70 @@ namespace {
 const iconv_t ICONV_NULL = (iconv_t)(-1);
 
 #ifdef HAVE_FRIBIDI
+
+/**
+   Checks the UTF-8 lead bytes of @a src for blocks that contain right to
+   left characters or bidi control characters. Errs on the side of
+   reordering, anything it lets through is left to right only.
+*/
+bool mayNeedReordering(const FbTk::FbString& src) {
+
+    const unsigned char *s = reinterpret_cast<const unsigned char *>(src.data());
+    const size_t size = src.size();
+
+    for (size_t i = 0; i < size; ++i) {
+        const unsigned char c = s[i];
+        if (c < 0x80)
+            continue;
+
+        const unsigned char next = (i + 1 < size) ? s[i + 1] : 0;
+
+        if ((c >= 0xD6 && c <= 0xDF) ||  // U+0580 - U+07FF: Hebrew, Arabic, ...
+            c == 0xE0 ||                 // U+0800 - U+0FFF: Samaritan, Mandaic, ...
+            (c == 0xE2 && (next == 0x80 || next == 0x81)) || // bidi controls
+            (c == 0xEF && next >= 0xAC && next <= 0xBB) ||  // presentation forms
+            (c == 0xF0 && (next == 0x90 || next == 0x9E)))  // historic scripts
+            return true;
+    }
+    return false;
+}
+
 FbTk::FbString makeVisualFromLogical(const FbTk::FbString& src) {
 
     FriBidiCharType base = FRIBIDI_TYPE_N;
 
-    // reuse allocated memory for reencoding / reordering
-    static std::vector<FriBidiChar> us;
-    static std::vector<FriBidiChar> out_us;
-    static FbTk::FbString result;
-
     const size_t S = src.size() + 1;
     const size_t S4 = S * 4;
 
-    if (us.capacity() < S)
-        us.reserve(S);
-    if (out_us.capacity() < S)
-        out_us.reserve(S);
-    if (result.capacity() < S4)
-        result.reserve(S4);
-
-    us.resize(S);
+    std::vector<FriBidiChar> us(S);
     FriBidiStrIndex len = fribidi_charset_to_unicode(FRIBIDI_CHAR_SET_UTF8,
             const_cast<char*>(src.c_str()), S - 1,
             &us[0]);
 
-    out_us.resize(S);
+    std::vector<FriBidiChar> out_us(S);
     fribidi_log2vis(&us[0], len, &base, &out_us[0], NULL, NULL, NULL);
 
-    result.resize(S4);
+    std::vector<char> result(S4);
     len = fribidi_unicode_to_charset(FRIBIDI_CHAR_SET_UTF8, &out_us[0], len, &result[0]);
-    result.resize(len); // trim to currently used chars
 
-    return result;
+    return FbTk::FbString(&result[0], len);
+}
+
+/// the same titles are reordered over and over by menus, tabs and the iconbar
+const FbTk::FbString& cachedVisual(const FbTk::FbString& logical) {
+
+    typedef std::map<FbTk::FbString, FbTk::FbString> VisualCache;
+    static VisualCache cache;
+    static const size_t CACHE_SIZE = 256;
+
+    VisualCache::iterator it = cache.find(logical);
+    if (it != cache.end())
+        return it->second;
+
+    if (cache.size() >= CACHE_SIZE)
+        cache.clear();
+
+    return cache.insert(std::make_pair(logical, makeVisualFromLogical(logical))).first->second;
 }
 
 #endif
@@ -111,7 +144,7 @@ namespace FbTk {
 
 BiDiString::BiDiString(const FbString& logical) 
 #ifdef HAVE_FRIBIDI
-    : m_visual_dirty(false)
+    : m_visual_dirty(false), m_visual_is_logical(true)
 #endif
 {
     if (!logical.empty())
@@ -123,6 +156,7 @@ const FbString& BiDiString::setLogical(const FbString& logical) {
 #if HAVE_FRIBIDI
     if (m_logical.empty()) {
         m_visual_dirty = false;
+        m_visual_is_logical = true;
         m_visual.clear();
     } else {
         m_visual_dirty = true;
@@ -134,10 +168,14 @@ const FbString& BiDiString::setLogical(const FbString& logical) {
 const FbString& BiDiString::visual() const {
 #if HAVE_FRIBIDI
     if (m_visual_dirty) {
-        m_visual = ::makeVisualFromLogical(logical());
+        m_visual_is_logical = !::mayNeedReordering(m_logical);
+        if (m_visual_is_logical)
+            m_visual.clear();
+        else
+            m_visual = ::cachedVisual(m_logical);
     }
     m_visual_dirty = false;
-    return m_visual;
+    return m_visual_is_logical ? m_logical : m_visual;
 #else
     return m_logical;
 #endif
@@ -157,8 +195,28 @@ enum ConvType {
 
 static bool s_inited = false;
 static iconv_t s_iconv_convs[CONVSIZE];
+/// conversions that leave 7 bit strings untouched, they are skipped for those
+static bool s_ascii_safe[CONVSIZE];
 static std::string s_locale_codeset;
 
+std::string recode(iconv_t cd, const std::string &in);
+
+/// @return true if @a cd maps every printable 7 bit character to itself
+bool isAsciiSafe(iconv_t cd) {
+#ifdef HAVE_ICONV
+    if (cd == ICONV_NULL)
+        return true; // recode() returns the input anyway
+
+    std::string ascii("\t\n");
+    for (char c = 0x20; c < 0x7f; ++c)
+        ascii += c;
+
+    return recode(cd, ascii) == ascii;
+#else
+    return true;
+#endif // HAVE_ICONV
+}
+
 /// Initialise all of the iconv conversion descriptors
 void init() {
 
@@ -190,6 +248,9 @@ void init() {
     memset(s_iconv_convs, 0, sizeof(s_iconv_convs));
 #endif // HAVE_ICONV
 
+    for (int i = 0; i < CONVSIZE; ++i)
+        s_ascii_safe[i] = isAsciiSafe(s_iconv_convs[i]);
+
 }
 
 void shutdown() {
@@ -200,10 +261,29 @@ void shutdown() {
             iconv_close(s_iconv_convs[i]);
 
     memset(s_iconv_convs, 0, sizeof(s_iconv_convs));
+    memset(s_ascii_safe, 0, sizeof(s_ascii_safe));
     s_inited = false;
 #endif // HAVE_ICONV
 }
 
+bool isAscii(const std::string &src) {
+    for (size_t i = 0; i < src.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(src[i]);
+        // control bytes like ESC, SO and SI switch charsets in 7 bit
+        // encodings such as ISO-2022-JP, so those need iconv as well
+        if (c >= 0x80 || (c < 0x20 && c != '\t' && c != '\n') || c == 0x7f)
+            return false;
+    }
+    return true;
+}
+
+/// recodes with one of the shared descriptors, 7 bit strings are passed through
+std::string recode(ConvType type, const std::string &in) {
+    if (s_ascii_safe[type] && isAscii(in))
+        return in;
+    return recode(s_iconv_convs[type], in);
+}
+
 
 
 
@@ -267,8 +347,7 @@ std::string recode(iconv_t cd, const std::string &in) {
                 // need more space!
                 outsize += insize;
                 out.resize(outsize);
-                if (out.capacity() != outsize)
-                    again = true;
+                again = true;
                 outbytesleft += insize;
                 out_ptr = (&out[0] + outsize) - outbytesleft;
                 break;
@@ -294,21 +373,21 @@ std::string recode(iconv_t cd, const std::string &in) {
 }
 
 FbString XStrToFb(const std::string &src) {
-    return recode(s_iconv_convs[X2FB], src);
+    return recode(X2FB, src);
 }
 
 std::string FbStrToX(const FbString &src) {
-    return recode(s_iconv_convs[FB2X], src);
+    return recode(FB2X, src);
 }
 
 
 /// Handle thislocale string encodings (strings coming from userspace)
 FbString LocaleStrToFb(const std::string &src) {
-    return recode(s_iconv_convs[LOCALE2FB], src);
+    return recode(LOCALE2FB, src);
 }
 
 std::string FbStrToLocale(const FbString &src) {
-    return recode(s_iconv_convs[FB2LOCALE], src);
+    return recode(FB2LOCALE, src);
 }
 
 bool haveUTF8() {
@@ -324,14 +403,15 @@ bool haveUTF8() {
 } // end namespace StringUtil
 
 #ifdef HAVE_ICONV
-StringConvertor::StringConvertor(EncodingTarget target) : m_iconv(ICONV_NULL) {
+StringConvertor::StringConvertor(EncodingTarget target) :
+    m_iconv(ICONV_NULL), m_ascii_safe(true) {
     if (target == ToLocaleStr)
         m_destencoding = FbStringUtil::s_locale_codeset;
     else
         m_destencoding = "UTF-8";
 }
 #else
-StringConvertor::StringConvertor(EncodingTarget target) { }
+StringConvertor::StringConvertor(EncodingTarget target) : m_ascii_safe(true) { }
 #endif
 
 StringConvertor::~StringConvertor() {
@@ -353,6 +433,7 @@ bool StringConvertor::setSource(const std::string &encoding) {
         if (m_iconv != ICONV_NULL)
             iconv_close(m_iconv);
         m_iconv = newiconv;
+        m_ascii_safe = FbStringUtil::isAsciiSafe(m_iconv);
         return true;
     }
 #else
@@ -362,6 +443,8 @@ bool StringConvertor::setSource(const std::string &encoding) {
 
 FbString StringConvertor::recode(const std::string &src) {
 #ifdef HAVE_ICONV
+    if (m_ascii_safe && FbStringUtil::isAscii(src))
+        return src;
     return FbStringUtil::recode(m_iconv, src);
 #else
     return src;
@@ -373,6 +456,7 @@ void StringConvertor::reset() {
     if (m_iconv != ICONV_NULL)
         iconv_close(m_iconv);
     m_iconv = ICONV_NULL;
+    m_ascii_safe = true;
 #endif
 }
 
@@ -54,6 +54,8 @@ private:
 #ifdef HAVE_FRIBIDI
     mutable FbString m_visual;
     mutable bool m_visual_dirty;
+    /// visual order equals logical order, m_visual is not used
+    mutable bool m_visual_is_logical;
 #endif
 };
 
@@ -75,8 +77,15 @@ std::string FbStrToLocale(const FbString &src);
 
 bool haveUTF8();
 
+/// @return true if @a src only contains printable 7 bit characters, tabs
+/// and newlines
+bool isAscii(const std::string &src);
+
 } // namespace FbStringUtil
 
+/// Converts strings from one encoding, keeps its own iconv descriptor.
+/// The FbStringUtil functions share theirs, so code that converts strings
+/// outside of the main thread should use a StringConvertor of its own.
 class StringConvertor: private NotCopyable {
 public:
 
@@ -95,6 +104,8 @@ private:
     iconv_t m_iconv;
 #endif
     std::string m_destencoding;
+    /// the conversion leaves 7 bit strings as they are
+    bool m_ascii_safe;
 };
 
 } // namespace FbTk
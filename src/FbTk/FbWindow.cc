@@ -27,6 +27,9 @@
 #include "Color.hh"
 #include "App.hh"
 #include "Transparent.hh"
+#include "PropertyPrefetch.hh"
+#include "Timer.hh"
+#include "MapState.hh"
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -42,6 +45,7 @@
 #endif
 
 #include <limits>
+#include <vector>
 
 namespace FbTk {
 
@@ -195,6 +199,8 @@ void FbWindow::updateBackground(bool only_if_alpha) {
         Pixmap root = FbPixmap::getRootPixmap(screenNumber());
         if (alpha != 255 && m_transparent->source() != root)
             m_transparent->setSource(root, screenNumber());
+        if (alpha != 255)
+            m_stale_alpha_wins.erase(this);
 
         FbPixmap newpm = FbPixmap(*this, width(), height(), depth());
         free_newbg = true; // newpm gets released to newbg at end of block
@@ -441,10 +447,15 @@ void FbWindow::setNew(Window win) {
 }
 
 void FbWindow::show() {
+    // catch up before mapping, so the old root doesn't show up
+    if (!m_stale_alpha_wins.empty())
+        refreshStaleSubtree(*this, true);
     XMapWindow(display(), m_window);
 }
 
 void FbWindow::showSubwindows() {
+    if (!m_stale_alpha_wins.empty())
+        refreshStaleSubtree(*this, false);
     XMapSubwindows(display(), m_window);
 }
 
@@ -516,7 +527,7 @@ FbTk::FbString FbWindow::textProperty(Atom prop,bool*exists) const {
     static const Atom utf8string = XInternAtom(display(), "UTF8_STRING", False);
 
     if (exists) *exists=false;
-    if (XGetTextProperty(display(), window(), &text_prop, prop) == 0 || text_prop.value == 0 || text_prop.nitems == 0) {
+    if (PropertyPrefetch::getTextProperty(display(), window(), &text_prop, prop) == 0 || text_prop.value == 0 || text_prop.nitems == 0) {
         return "";
     }
 
@@ -564,11 +575,11 @@ bool FbWindow::property(Atom prop,
                         unsigned long *nitems_return,
                         unsigned long *bytes_after_return,
                         unsigned char **prop_return) const {
-    if (XGetWindowProperty(display(), window(),
-                           prop, long_offset, long_length, do_delete,
-                           req_type, actual_type_return,
-                           actual_format_return, nitems_return,
-                           bytes_after_return, prop_return) == Success)
+    if (PropertyPrefetch::getProperty(display(), window(),
+                                      prop, long_offset, long_length, do_delete,
+                                      req_type, actual_type_return,
+                                      actual_format_return, nitems_return,
+                                      bytes_after_return, prop_return) == Success)
         return true;
 
     return false;
@@ -580,12 +591,14 @@ void FbWindow::changeProperty(Atom prop, Atom type,
                               unsigned char *data,
                               int nelements) {
 
+    PropertyPrefetch::invalidate(m_window, prop);
     XChangeProperty(display(), m_window, prop, type,
                     format, mode,
                     data, nelements);
 }
 
 void FbWindow::deleteProperty(Atom prop) {
+    PropertyPrefetch::invalidate(m_window, prop);
     XDeleteProperty(display(), m_window, prop);
 }
 
@@ -700,6 +713,14 @@ void FbWindow::sendConfigureNotify(int x, int y,
 }
 
 FbWindow::FbWinList FbWindow::m_alpha_wins;
+FbWindow::FbWinList FbWindow::m_stale_alpha_wins;
+
+namespace {
+
+// never destroyed, the timer list might be gone by then
+Timer *s_stale_alpha_timer = 0;
+
+} // end anonymous namespace
 
 void FbWindow::addAlphaWin(FbWindow &win) {
     m_alpha_wins.insert(&win);
@@ -709,16 +730,79 @@ void FbWindow::removeAlphaWin(FbWindow &win) {
     FbWinList::iterator it = m_alpha_wins.find(&win);
     if (it != m_alpha_wins.end())
         m_alpha_wins.erase(it);
+
+    m_stale_alpha_wins.erase(&win);
+    if (m_stale_alpha_wins.empty() && s_stale_alpha_timer != 0 &&
+        s_stale_alpha_timer->isTiming())
+        s_stale_alpha_timer->stop();
 }
 
 void FbWindow::updatedAlphaBackground(int screen) {
     FbWinList::iterator it = m_alpha_wins.begin();
     FbWinList::iterator it_end = m_alpha_wins.end();
     for (; it != it_end; ++it) {
-        if ((*it)->screenNumber() == screen) {
-            (*it)->updateBackground(false);
-            (*it)->clear();
-        }
+        if ((*it)->screenNumber() == screen)
+            m_stale_alpha_wins.insert(*it);
+    }
+
+    if (!m_stale_alpha_wins.empty())
+        scheduleStaleAlphaWins();
+}
+
+void FbWindow::scheduleStaleAlphaWins() {
+    // a 0 timeout fires once the event queue is drained, so all the
+    // root property changes of one wallpaper switch end up in one batch
+    if (s_stale_alpha_timer == 0) {
+        s_stale_alpha_timer = new Timer();
+        s_stale_alpha_timer->setTimeout(0, 0);
+        s_stale_alpha_timer->fireOnce(true);
+        s_stale_alpha_timer->setFunctor(&FbWindow::refreshStaleAlphaWins);
+    }
+
+    if (!s_stale_alpha_timer->isTiming())
+        s_stale_alpha_timer->start();
+}
+
+void FbWindow::refreshStaleSubtree(const FbWindow &top, bool with_top) {
+    // only what gets mapped along with top, so this costs nothing but
+    // a walk up the parents for stale windows elsewhere
+    std::vector<FbWindow *> mapped;
+    FbWinList::iterator it = m_stale_alpha_wins.begin();
+    FbWinList::iterator it_end = m_stale_alpha_wins.end();
+    for (; it != it_end; ++it) {
+        const FbWindow *win = with_top ? *it : (*it)->parent();
+        for (; win != 0 && win != &top; win = win->parent())
+            ;
+        if (win != 0)
+            mapped.push_back(*it);
+    }
+
+    for (size_t i = 0; i < mapped.size(); ++i) {
+        mapped[i]->updateBackground(false);
+        mapped[i]->clear();
+    }
+}
+
+void FbWindow::refreshStaleAlphaWins() {
+    if (m_stale_alpha_wins.empty())
+        return;
+
+    std::vector<FbWindow *> stale(m_stale_alpha_wins.begin(),
+                                  m_stale_alpha_wins.end());
+    std::vector<Window> windows(stale.size());
+    for (size_t i = 0; i < stale.size(); ++i)
+        windows[i] = stale[i]->window();
+
+    std::vector<int> states;
+    getMapStates(stale[0]->display(), windows, states);
+
+    // the others are on another workspace, a hidden menu, ...
+    for (size_t i = 0; i < stale.size(); ++i) {
+        if (states[i] != IsViewable)
+            continue;
+        m_stale_alpha_wins.erase(stale[i]);
+        stale[i]->updateBackground(false);
+        stale[i]->clear();
     }
 }
 
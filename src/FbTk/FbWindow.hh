@@ -208,6 +208,9 @@ public:
     /// forces full background change, recalcing of alpha values if necessary
     void updateBackground(bool only_if_alpha);
 
+    /// marks the transparent windows of the screen stale, the viewable
+    /// ones get refreshed in one batch once the event queue is idle and
+    /// the others when they or one of their parents get mapped
     static void updatedAlphaBackground(int screen);
 
     /// updates x,y, width, height and screen num from X window
@@ -250,9 +253,15 @@ private:
 
     static void addAlphaWin(FbWindow &win);
     static void removeAlphaWin(FbWindow &win);
+    /// refreshes stale windows that have become viewable
+    static void refreshStaleAlphaWins();
+    /// refreshes stale windows that get mapped along with @a top
+    static void refreshStaleSubtree(const FbWindow &top, bool with_top);
+    static void scheduleStaleAlphaWins();
 
     typedef std::set<FbWindow *> FbWinList;
     static FbWinList m_alpha_wins;
+    static FbWinList m_stale_alpha_wins; ///< waiting for a new background
 };
 
 bool operator == (Window win, const FbWindow &fbwin);
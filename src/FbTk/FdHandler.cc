@@ -0,0 +1,88 @@
+// FdHandler.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "FdHandler.hh"
+
+#include <vector>
+
+namespace FbTk {
+
+FdHandler &FdHandler::instance() {
+    static FdHandler singleton;
+    return singleton;
+}
+
+void FdHandler::registerHandler(int fd, FdEventHandler *eh) {
+    if (fd < 0 || eh == 0)
+        return;
+    m_handlers[fd].handler = eh;
+}
+
+void FdHandler::unregisterHandler(int fd) {
+    m_handlers.erase(fd);
+}
+
+void FdHandler::setReadInterest(int fd, bool interest) {
+    Handlers::iterator it = m_handlers.find(fd);
+    if (it != m_handlers.end())
+        it->second.read_interest = interest;
+}
+
+void FdHandler::setWriteInterest(int fd, bool interest) {
+    Handlers::iterator it = m_handlers.find(fd);
+    if (it != m_handlers.end())
+        it->second.write_interest = interest;
+}
+
+int FdHandler::fillSets(fd_set &rfds, fd_set &wfds, int maxfd) const {
+    Handlers::const_iterator it = m_handlers.begin();
+    Handlers::const_iterator it_end = m_handlers.end();
+    for (; it != it_end; ++it) {
+        if (it->second.read_interest)
+            FD_SET(it->first, &rfds);
+        if (it->second.write_interest)
+            FD_SET(it->first, &wfds);
+        if (it->first > maxfd)
+            maxfd = it->first;
+    }
+    return maxfd;
+}
+
+void FdHandler::dispatch(const fd_set &rfds, const fd_set &wfds) {
+    // handlers may register or unregister descriptors while we
+    // call them, so collect the ready ones first
+    std::vector<int> ready;
+    Handlers::iterator it = m_handlers.begin();
+    Handlers::iterator it_end = m_handlers.end();
+    for (; it != it_end; ++it) {
+        if ((it->second.read_interest && FD_ISSET(it->first, &rfds)) ||
+            (it->second.write_interest && FD_ISSET(it->first, &wfds)))
+            ready.push_back(it->first);
+    }
+
+    for (size_t i = 0; i < ready.size(); ++i) {
+        it = m_handlers.find(ready[i]);
+        if (it != m_handlers.end())
+            it->second.handler->handleFdEvent(ready[i]);
+    }
+}
+
+} // end namespace FbTk
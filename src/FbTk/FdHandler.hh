@@ -0,0 +1,91 @@
+// FdHandler.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FBTK_FDHANDLER_HH
+#define FBTK_FDHANDLER_HH
+
+#include <map>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#ifdef HAVE_SYS_SELECT_H
+#  include <sys/select.h>
+#endif
+#include <sys/types.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace FbTk {
+
+/// Base class that FdHandler calls when a file descriptor is ready
+class FdEventHandler {
+public:
+    /// called when @a fd is ready for the events it is registered for
+    virtual void handleFdEvent(int fd) = 0;
+    virtual ~FdEventHandler() { }
+};
+
+///   Watches file descriptors next to the X connection, singleton.
+/**
+   Usage: inherit the class FdEventHandler and then register
+   it to FdHandler by calling registerHandler with a file descriptor.
+   The descriptors are waited on in Timer::updateTimers, together with
+   the X connection, so handlers run from the main event loop.
+*/
+class FdHandler {
+public:
+    /// get singleton object
+    static FdHandler &instance();
+
+    void registerHandler(int fd, FdEventHandler *eh);
+    void unregisterHandler(int fd);
+    /// wait for @a fd to become readable, enabled by default
+    void setReadInterest(int fd, bool interest);
+    /// wait for @a fd to become writable, disabled by default
+    void setWriteInterest(int fd, bool interest);
+
+    /**
+       Adds all registered descriptors to the sets.
+       @return the highest descriptor in the sets, at least @a maxfd
+    */
+    int fillSets(fd_set &rfds, fd_set &wfds, int maxfd) const;
+    /// calls the handler of every registered descriptor that is set
+    void dispatch(const fd_set &rfds, const fd_set &wfds);
+    bool empty() const { return m_handlers.empty(); }
+
+private:
+    FdHandler() { }
+
+    struct Entry {
+        Entry(): handler(0), read_interest(true), write_interest(false) { }
+        FdEventHandler *handler;
+        bool read_interest;
+        bool write_interest;
+    };
+    typedef std::map<int, Entry> Handlers;
+    Handlers m_handlers;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_FDHANDLER_HH
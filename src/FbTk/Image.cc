@@ -20,6 +20,7 @@
 // DEALINGS IN THE SOFTWARE.
 
 #include "Image.hh"
+#include "PixmapWithMask.hh"
 #include "StringUtil.hh"
 #include "FileUtil.hh"
 
@@ -51,6 +52,72 @@ typedef std::list<std::string> StringList;
 ImageMap s_image_map;
 StringList s_search_paths;
 
+// locateFile results. Found files are kept for as long as the search
+// paths are the same and the file is still there, so a style reload
+// (which removes and adds the same paths) doesn't search them again.
+// Files that weren't found are searched again whenever a search path
+// gets added or removed.
+typedef std::map<std::string, std::string> LocateMap;
+LocateMap s_located;
+std::set<std::string> s_not_found;
+std::string s_search_paths_key;
+
+void searchPathsChanged() {
+    s_not_found.clear();
+    s_search_paths_key.clear();
+    for (StringList::iterator it = s_search_paths.begin();
+         it != s_search_paths.end(); ++it)
+        s_search_paths_key += *it + '\n';
+}
+
+// decoded images, so the same file isn't decoded again by each screen
+// and on each reconfigure. The loaders return a new image each time, so
+// we hand out copies, which only costs a copy in the server.
+struct CachedImage {
+    time_t changed; ///< status change time of the file when it was loaded
+    FbTk::PixmapWithMask *image;
+};
+
+typedef std::pair<std::string, int> ImageKey; // path, screen
+typedef std::map<ImageKey, CachedImage> ImageCache;
+typedef std::list<ImageKey> ImageKeys;
+
+ImageCache s_image_cache;
+ImageKeys s_image_order; ///< least recently used first
+const size_t MAX_CACHED_IMAGES = 64;
+
+FbTk::PixmapWithMask *copyImage(const FbTk::PixmapWithMask &image) {
+    FbTk::PixmapWithMask *copy = new FbTk::PixmapWithMask();
+    copy->pixmap().copy(image.pixmap());
+    copy->mask().copy(image.mask());
+    return copy;
+}
+
+string searchFile(const string &filename) {
+    string path = FbTk::StringUtil::expandFilename(filename);
+    if (FbTk::FileUtil::isRegularFile(path.c_str()))
+        return path;
+    string base = FbTk::StringUtil::basename(filename);
+    StringList::iterator it = s_search_paths.begin();
+    StringList::iterator it_end = s_search_paths.end();
+    for (; it != it_end; ++it) {
+        path = FbTk::StringUtil::expandFilename(*it) + "/" + base;
+        if (FbTk::FileUtil::isRegularFile(path.c_str()))
+            return path;
+    }
+    return "";
+}
+
+// takes a copy of the key, it may well be the one in s_image_order
+void uncacheImage(ImageKey key) {
+    ImageCache::iterator it = s_image_cache.find(key);
+    if (it == s_image_cache.end())
+        return;
+    delete it->second.image;
+    s_image_cache.erase(it);
+    s_image_order.remove(key);
+}
+
 #ifdef HAVE_IMLIB2
 FbTk::ImageImlib2 imlib2_loader;
 #endif
@@ -77,25 +144,60 @@ PixmapWithMask *Image::load(const string &filename, int screen_num) {
         return NULL;
 
     string path = locateFile(filename);
-    if (!path.empty())
-        return s_image_map[extension]->load(path, screen_num);
+    if (path.empty())
+        return 0;
+
+    time_t changed = FileUtil::getLastStatusChangeTimestamp(path.c_str());
+    ImageKey key(path, screen_num);
+    ImageCache::iterator it = s_image_cache.find(key);
+    if (it != s_image_cache.end()) {
+        if (it->second.changed == changed) {
+            s_image_order.remove(key);
+            s_image_order.push_back(key);
+            return copyImage(*it->second.image);
+        }
+        // the file changed
+        uncacheImage(key);
+    }
+
+    PixmapWithMask *image = s_image_map[extension]->load(path, screen_num);
+    if (image == 0 || changed == -1)
+        return image;
+
+    if (s_image_order.size() >= MAX_CACHED_IMAGES)
+        uncacheImage(s_image_order.front());
+
+    CachedImage &cached = s_image_cache[key];
+    cached.changed = changed;
+    cached.image = copyImage(*image);
+    s_image_order.push_back(key);
+
+    return image;
+}
 
-    return 0;
+void Image::clearCache() {
+    while (!s_image_order.empty())
+        uncacheImage(s_image_order.front());
+    s_located.clear();
+    s_not_found.clear();
 }
 
 string Image::locateFile(const string &filename) {
-    string path = StringUtil::expandFilename(filename);
-    if (FileUtil::isRegularFile(path.c_str()))
-        return path;
-    string base = StringUtil::basename(filename);
-    StringList::iterator it = s_search_paths.begin();
-    StringList::iterator it_end = s_search_paths.end();
-    for (; it != it_end; ++it) {
-        path = StringUtil::expandFilename(*it) + "/" + base;
-        if (FileUtil::isRegularFile(path.c_str()))
-            return path;
-    }
-    return "";
+    const string key = s_search_paths_key + filename;
+    LocateMap::iterator located = s_located.find(key);
+    if (located != s_located.end()) {
+        if (FileUtil::isRegularFile(located->second.c_str()))
+            return located->second;
+        s_located.erase(located);
+    } else if (s_not_found.find(key) != s_not_found.end())
+        return "";
+
+    string path = searchFile(filename);
+    if (path.empty())
+        s_not_found.insert(key);
+    else
+        s_located[key] = path;
+    return path;
 }
 
 bool Image::registerType(const string &type, ImageBase &base) {
@@ -133,14 +235,17 @@ void Image::remove(ImageBase &base) {
 
 void Image::addSearchPath(const string &search_path) {
     s_search_paths.push_back(search_path);
+    searchPathsChanged();
 }
 
 void Image::removeSearchPath(const string &search_path) {
     s_search_paths.remove(search_path);
+    searchPathsChanged();
 }
 
 void Image::removeAllSearchPaths() {
     s_search_paths.clear();
+    searchPathsChanged();
 }
 
 } // end namespace FbTk
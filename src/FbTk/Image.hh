@@ -48,8 +48,10 @@ namespace Image {
     void removeSearchPath(const std::string &search_path);
     /// adds a path to search images from
     void removeAllSearchPaths();
-    /// locates an image in the search path
+    /// locates an image in the search path, remembers what it found
     std::string locateFile(const std::string &filename);
+    /// frees the decoded images, must happen before the display is closed
+    void clearCache();
 }
 
 /// common interface for all image classes
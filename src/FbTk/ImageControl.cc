@@ -177,7 +177,9 @@ struct ImageControl::Cache {
 ImageControl::ImageControl(int screen_num,
                            int cpc, unsigned long cache_timeout, unsigned long cmax):
     m_colors_per_channel(cpc),
-    m_screen_num(screen_num) {
+    m_screen_num(screen_num),
+    m_cache_hits(0),
+    m_cache_misses(0) {
 
     Display *disp = FbTk::App::instance()->display();
 
@@ -286,6 +288,7 @@ Pixmap ImageControl::renderImage(unsigned int width, unsigned int height,
 
     // If we are not suppose to cache this pixmap, just render and return it
     if ( ! use_cache) {
+        StatTimer stat_timer(m_render_stat);
         TextureRender image(*this, width, height, orient);
         return image.render(texture);
     }
@@ -293,13 +296,18 @@ Pixmap ImageControl::renderImage(unsigned int width, unsigned int height,
     // search cache first
     Pixmap pixmap = searchCache(width, height, texture, orient);
     if (pixmap) {
+        ++m_cache_hits;
         return pixmap; // return cache item
     }
+    ++m_cache_misses;
 
     // render new image
 
-    TextureRender image(*this, width, height, orient);
-    pixmap = image.render(texture);
+    {
+        StatTimer stat_timer(m_render_stat);
+        TextureRender image(*this, width, height, orient);
+        pixmap = image.render(texture);
+    }
 
     if (pixmap) {
         // create new cache item and add it to cache list
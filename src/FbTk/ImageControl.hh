@@ -74,6 +74,14 @@ public:
                             unsigned int **, unsigned int **);
 
     void cleanCache();
+
+    // statistics, see Stats
+    unsigned long cacheHits() const { return m_cache_hits; }
+    unsigned long cacheMisses() const { return m_cache_misses; }
+    size_t cacheSize() const { return cache.size(); }
+    /// time spent rendering textures
+    const TimeStat &renderStat() const { return m_render_stat; }
+
 private:
     /** 
         Search cache for a specific pixmap
@@ -111,6 +119,9 @@ private:
 
     mutable CacheList cache;
     unsigned long cache_max;
+
+    unsigned long m_cache_hits, m_cache_misses;
+    TimeStat m_render_stat;
 };
 
 } // end namespace FbTk
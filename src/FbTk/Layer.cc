@@ -22,7 +22,6 @@
 
 #include "Layer.hh"
 #include "LayerItem.hh"
-#include "App.hh"
 #include "FbWindow.hh"
 #include "MultLayers.hh"
 
@@ -74,32 +73,11 @@ void extract_windows_to_stack(const FbTk::Layer::ItemList& items, LayerItem* tem
     }
 }
 
-void restack(const FbTk::Layer::ItemList& items, LayerItem* temp_raised) {
-
-    std::vector<Window> stack;
-    extract_windows_to_stack(items, temp_raised, stack);
-
-    if (!stack.empty())
-        XRestackWindows(FbTk::App::instance()->display(), &stack[0], stack.size());
-}
-
 } // end of anonymous namespace
 
 
-void Layer::restack(const std::vector<Layer*>& layers) {
-
-    std::vector<Window> stack;
-    std::vector<Layer*>::const_iterator l;
-    for (l = layers.begin(); l != layers.end(); ++l) {
-        extract_windows_to_stack((*l)->itemList(), 0, stack);
-    }
-
-    if (!stack.empty())
-        XRestackWindows(FbTk::App::instance()->display(), &stack[0], stack.size());
-}
-
 Layer::Layer(MultLayers &manager, int layernum):
-    m_manager(manager), m_layernum(layernum), m_needs_restack(false) {
+    m_manager(manager), m_layernum(layernum), m_temp_raised(0) {
 }
 
 Layer::~Layer() {
@@ -107,14 +85,12 @@ Layer::~Layer() {
 }
 
 void Layer::restack() {
-    if (m_manager.isUpdatable()) {
-        ::restack(itemList(), 0);
-        m_needs_restack = false;
-    }
+    m_temp_raised = 0;
+    m_manager.restack();
 }
 
-void Layer::restackAndTempRaise(LayerItem &item) {
-    ::restack(itemList(), &item);
+void Layer::extractWindows(std::vector<Window> &stack) const {
+    extract_windows_to_stack(itemList(), m_temp_raised, stack);
 }
 
 int Layer::countWindows() {
@@ -122,60 +98,27 @@ int Layer::countWindows() {
 }
 
 
-// Stack all windows associated with 'item' below the 'above' item
+// Stack all windows associated with 'item' below the 'above' item,
+// or on top of the layer if 'above' isn't in it
 void Layer::stackBelowItem(LayerItem &item, LayerItem *above) {
-    if (!m_manager.isUpdatable())
-        return;
-
-    // if there are no windows provided for above us,
-    // then we must restack the entire layer
-    // we can't do XRaiseWindow because a restack then causes OverrideRedirect
-    // windows to get pushed to the bottom
-    if (!above || m_needs_restack) { // must need to go right to top
-        restack();
+    iterator it = std::find(itemList().begin(), itemList().end(), &item);
+    if (it == itemList().end())
         return;
-    }
 
-    std::vector<Window> stack;
+    itemList().erase(it);
 
-    // We do have a window to stack below
-    // so we put it on top, and fill the rest of the array with the ones to go below it.
-    // assume that above's window exists
-    stack.push_back(above->getWindows().back()->window());
-
-    // fill the rest of the array
-    extract_windows_to_stack(item.getWindows(), stack);
+    it = std::find(itemList().begin(), itemList().end(), above);
+    if (it == itemList().end())
+        itemList().push_front(&item);
+    else
+        itemList().insert(++it, &item);
 
-    XRestackWindows(FbTk::App::instance()->display(), &stack[0], stack.size());
+    restack();
 }
 
-// We can't just use Restack here, because it won't do anything if they're
-// already in the same relative order excluding other windows
+// called when a window got added to the item
 void Layer::alignItem(LayerItem &item) {
-    if (itemList().front() == &item) {
-        stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
-        return;
-    }
-
-    // Note: some other things effectively assume that the window list is
-    // sorted from highest to lowest
-    // get our item
-    iterator myit = std::find(itemList().begin(), itemList().end(), &item);
-    iterator it = myit;
-
-    // go to the one above it in our layer (top is front, so we decrement)
-    --it;
-
-    // keep going until we find one that is currently visible to the user
-    while (it != itemList().begin() && !(*it)->visible())
-        --it;
-
-    if (it == itemList().begin() && !(*it)->visible())
-        // reached front item, but it wasn't visible, therefore it was already raised
-        stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
-    else
-        stackBelowItem(item, *it);
-
+    restack();
 }
 
 Layer::iterator Layer::insert(LayerItem &item, unsigned int pos) {
@@ -186,12 +129,14 @@ Layer::iterator Layer::insert(LayerItem &item, unsigned int pos) {
 #endif // DEBUG
 
     itemList().push_front(&item);
-    // restack below next window up
-    stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
+    restack();
     return itemList().begin();
 }
 
 void Layer::remove(LayerItem &item) {
+    if (m_temp_raised == &item)
+        m_temp_raised = 0;
+
     iterator it = itemList().begin();
     iterator it_end = itemList().end();
     for (; it != it_end; ++it) {
@@ -206,7 +151,7 @@ void Layer::raise(LayerItem &item) {
     // assume it is already in this layer
 
     if (&item == itemList().front()) {
-        if (m_needs_restack)
+        if (m_temp_raised)
             restack();
         return; // nothing to do
     }
@@ -223,14 +168,14 @@ void Layer::raise(LayerItem &item) {
     }
 
     itemList().push_front(&item);
-    stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
+    restack();
 
 }
 
 void Layer::tempRaise(LayerItem &item) {
     // assume it is already in this layer
 
-    if (!m_needs_restack && &item == itemList().front())
+    if (!m_temp_raised && &item == itemList().front())
         return; // nothing to do
 
     iterator it = std::find(itemList().begin(), itemList().end(), &item);
@@ -241,12 +186,9 @@ void Layer::tempRaise(LayerItem &item) {
         return;
     }
 
-    if (m_needs_restack)
-        restackAndTempRaise(item);
-    else
-        stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
-
-    m_needs_restack = true;
+    // the next restack puts it back
+    m_temp_raised = &item;
+    m_manager.restack();
 }
 
 void Layer::lower(LayerItem &item) {
@@ -254,7 +196,7 @@ void Layer::lower(LayerItem &item) {
 
     // is it already the lowest?
     if (&item == itemList().back()) {
-        if (m_needs_restack)
+        if (m_temp_raised)
             restack();
         return; // nothing to do
     }
@@ -272,20 +214,7 @@ void Layer::lower(LayerItem &item) {
 
     // add it to the bottom
     itemList().push_back(&item);
-
-    // find the item we need to stack below
-    // start at the end
-    it = itemList().end();
-
-    // go up one so we have an object (which must exist, since at least this item is in the layer)
-    it--;
-
-    // go down another one
-    // must exist, otherwise our item must == itemList().back()
-    it--;
-
-    // and restack our window below that one.
-    stackBelowItem(item, *it);
+    restack();
 }
 
 void Layer::raiseLayer(LayerItem &item) {
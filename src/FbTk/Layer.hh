@@ -23,6 +23,8 @@
 #ifndef FBTK_LAYER_HH
 #define FBTK_LAYER_HH
 
+#include <X11/Xlib.h>
+
 #include <vector>
 #include <list>
 
@@ -68,15 +70,15 @@ public:
     void lowerLayer(LayerItem &item);
     void moveToLayer(LayerItem &item, int layernum);
 
-    static void restack(const std::vector<Layer*>& layers);
+    /// adds the windows of this layer to @a stack, top to bottom
+    void extractWindows(std::vector<Window> &stack) const;
 
 private:
     void restack();
-    void restackAndTempRaise(LayerItem &item);
 
     MultLayers &m_manager;
     int m_layernum;
-    bool m_needs_restack;
+    LayerItem *m_temp_raised; ///< on top until the next restack
     ItemList m_items;
 };
 
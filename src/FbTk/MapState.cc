@@ -0,0 +1,98 @@
+// MapState.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+
+#include "MapState.hh"
+
+// Xlibint.h is needed to queue requests with async reply handlers, see
+// PropertyPrefetch.cc. It defines min and max as macros, so it has to
+// come last.
+#include <X11/Xlibint.h>
+#undef min
+#undef max
+
+namespace FbTk {
+
+namespace {
+
+struct Request {
+    unsigned long sequence;
+    int *state;
+    _XAsyncHandler handler;
+};
+
+// the same as the handler of XGetWindowAttributes, minus the geometry
+Bool handleReply(Display *dpy, xReply *rep, char *buf, int len, XPointer data) {
+    Request *request = reinterpret_cast<Request *>(data);
+
+    if (dpy->last_request_read != request->sequence)
+        return False;
+
+    // left to the regular error handler
+    if (rep->generic.type == X_Error)
+        return False;
+
+    xGetWindowAttributesReply replbuf;
+    xGetWindowAttributesReply *attr_rep = reinterpret_cast<xGetWindowAttributesReply *>(
+        _XGetAsyncReply(dpy, reinterpret_cast<char *>(&replbuf), rep, buf, len,
+                        (SIZEOF(xGetWindowAttributesReply) - SIZEOF(xReply)) >> 2,
+                        True));
+    *request->state = attr_rep->mapState;
+    return True;
+}
+
+} // end anonymous namespace
+
+void getMapStates(Display *dpy, const std::vector<Window> &windows,
+                  std::vector<int> &states) {
+    states.assign(windows.size(), IsUnmapped);
+    if (windows.empty())
+        return;
+
+    std::vector<Request> requests(windows.size());
+
+    LockDisplay(dpy);
+    for (size_t i = 0; i < windows.size(); ++i) {
+        Request &request = requests[i];
+        xResourceReq *req;
+        GetResReq(GetWindowAttributes, windows[i], req);
+
+        request.sequence = dpy->request;
+        request.state = &states[i];
+        request.handler.next = dpy->async_handlers;
+        request.handler.handler = handleReply;
+        request.handler.data = reinterpret_cast<XPointer>(&request);
+        dpy->async_handlers = &request.handler;
+    }
+    UnlockDisplay(dpy);
+    SyncHandle();
+
+    // one round trip for all of them
+    XSync(dpy, False);
+
+    LockDisplay(dpy);
+    for (size_t i = 0; i < requests.size(); ++i)
+        DeqAsyncHandler(dpy, &requests[i].handler);
+    UnlockDisplay(dpy);
+}
+
+} // end namespace FbTk
@@ -1,5 +1,5 @@
-// SearchResult.hh for FbTk - Fluxbox Toolkit
-// Copyright (c) 2007 Fluxbox Team (fluxgen at fluxbox dot org)
+// MapState.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
 //
 // Permission is hereby granted, free of charge, to any person obtaining a
 // copy of this software and associated documentation files (the "Software"),
@@ -19,37 +19,24 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 // DEALINGS IN THE SOFTWARE.
 
-#ifndef FBTK_SEARCHRESULT_HH
-#define FBTK_SEARCHRESULT_HH
 
+#ifndef FBTK_MAPSTATE_HH
+#define FBTK_MAPSTATE_HH
+
+#include <X11/Xlib.h>
 #include <vector>
-#include <string>
 
 namespace FbTk {
 
-class ITypeAheadable;
-
-class SearchResult {
-public:
-    typedef std::vector < ITypeAheadable* > BaseItems;
-    typedef BaseItems::iterator BaseItemsIt;
-
-    SearchResult(const std::string &to_search_for):
-        m_seeked_string(to_search_for) { }
-
-    void add(ITypeAheadable* item) { m_results.push_back(item); }
-    size_t size() const { return m_results.size(); }
-    const BaseItems& result() const { return m_results; }
-    const std::string& seekedString() const { return m_seeked_string; }
-
-    void seek();
-
-private:
-    BaseItems m_results;
-    std::string m_seeked_string;
-
-};
+/**
+   Asks for the map state of all @a windows in a single round trip,
+   instead of one XGetWindowAttributes each.
+   @param states gets IsUnmapped, IsUnviewable or IsViewable for each
+                 window, IsUnmapped if there was no answer
+*/
+void getMapStates(Display *disp, const std::vector<Window> &windows,
+                  std::vector<int> &states);
 
 } // end namespace FbTk
 
-#endif // FBTK_SEARCHRESULT_HH
+#endif // FBTK_MAPSTATE_HH
@@ -109,7 +109,8 @@ Menu::Menu(FbTk::ThemeProxy<MenuTheme> &tm, ImageControl &imgctrl):
     m_alignment(ALIGNDONTCARE),
     m_active_index(-1),
     m_shape(0),
-    m_need_update(true) {
+    m_need_update(true),
+    m_render_hidden(false) {
     // setup timers
 
     RefCount<Command<void> > show_cmd(new SimpleCommand<Menu>(*this, &Menu::openSubmenu));
@@ -121,6 +122,8 @@ Menu::Menu(FbTk::ThemeProxy<MenuTheme> &tm, ImageControl &imgctrl):
     m_hide_timer.setCommand(hide_cmd);
     m_hide_timer.fireOnce(true);
 
+    m_render_job.setFunctor(MemFun(*this, &Menu::renderHidden));
+
     // make sure we get updated when the theme is reloaded
     m_tracker.join(tm.reconfigSig(), MemFun(*this, &Menu::themeReconfigured));
 
@@ -133,7 +136,7 @@ Menu::Menu(FbTk::ThemeProxy<MenuTheme> &tm, ImageControl &imgctrl):
         m_visible = false;
 
 
-    m_type_ahead.init(menuitems);
+    m_search.init(menuitems);
 
     m_x_move =
         m_y_move = 0;
@@ -237,9 +240,11 @@ int Menu::insert(MenuItem *item, int pos) {
     if (pos == -1) {
         item->setIndex(menuitems.size());
         menuitems.push_back(item);
+        m_search.invalidate();
     } else {
         menuitems.insert(menuitems.begin() + pos, item);
         fixMenuItemIndices();
+        m_search.invalidate();
         if (m_active_index >= pos)
             m_active_index++;
     }
@@ -270,6 +275,7 @@ int Menu::remove(unsigned int index) {
         if (!m_matches.empty())
             resetTypeAhead();
         menuitems.erase(it);
+        m_search.invalidate();
         // avoid O(n^2) algorithm with removeAll()
         if (index != menuitems.size())
             fixMenuItemIndices();
@@ -318,7 +324,7 @@ void Menu::lower() {
 
 void Menu::cycleItems(bool reverse) {
     Menuitems vec;
-    if (m_type_ahead.stringSize())
+    if (m_search.size())
         vec = m_matches;
     else
         vec = menuitems;
@@ -396,6 +402,9 @@ void Menu::enableTitle() {
 }
 
 void Menu::updateMenu() {
+    // labels might have changed
+    m_search.invalidate();
+
     if (m_title_vis) {
         m_item_w = theme()->titleFont().textWidth(m_label);
         m_item_w += (theme()->bevelWidth() * 2);
@@ -469,8 +478,13 @@ void Menu::updateMenu() {
 
     m_window.resize(new_width, new_height);
 
-    if (!isVisible())
+    if (!isVisible() && !m_render_hidden) {
+        // have it ready before it gets shown, but only once
+        // there is nothing else to do
+        if (m_need_update)
+            m_render_job.schedule();
         return;
+    }
 
     if (m_frame.alpha() != alpha())
         m_frame.setAlpha(alpha());
@@ -529,6 +543,15 @@ void Menu::updateMenu() {
 }
 
 
+void Menu::renderHidden() {
+    if (isVisible() || !m_need_update)
+        return;
+
+    m_render_hidden = true;
+    updateMenu();
+    m_render_hidden = false;
+}
+
 void Menu::show() {
 
     if (isVisible() || menuitems.empty())
@@ -539,7 +562,7 @@ void Menu::show() {
     if (m_need_update)
         updateMenu();
 
-    m_type_ahead.reset();
+    m_search.clear();
     m_matches.clear();
 
     m_window.showSubwindows();
@@ -1108,17 +1131,17 @@ void Menu::keyPressEvent(XKeyEvent &event) {
             enterSubmenu();
         break;
     case XK_Escape: // close menu
-        m_type_ahead.reset();
+        m_search.clear();
         m_torn = false;
         hide(true);
         break;
     case XK_BackSpace:
-        if (m_type_ahead.stringSize() == 0) {
+        if (m_search.size() == 0) {
             internal_hide();
             break;
         }
 
-        m_type_ahead.putBackSpace();
+        m_search.backspace();
         drawTypeAheadItems();
         break;
     case XK_KP_Enter:
@@ -1142,15 +1165,15 @@ void Menu::keyPressEvent(XKeyEvent &event) {
         if (validIndex(m_active_index) && isItemEnabled(m_active_index) &&
             menuitems[m_active_index]->submenu() && m_matches.size() == 1) {
             enterSubmenu();
-            m_type_ahead.reset();
+            m_search.clear();
         } else {
-            m_type_ahead.seek();
+            m_search.seek();
             cycleItems((bool)(event.state & ShiftMask));
         }
         drawTypeAheadItems();
         break;
     default:
-        m_type_ahead.putCharacter(keychar[0]);
+        m_search.add(keychar[0]);
         // if current item doesn't match new search string, find the next one
         drawTypeAheadItems();
         if (!m_matches.empty() && (!validIndex(m_active_index) ||
@@ -1287,15 +1310,14 @@ void Menu::clearItem(int index, bool clear, int search_index) {
     bool highlight = (index == m_active_index && isItemSelectable(index));
 
     if (search_index < 0)
-        // find if we need to underline the item
-        search_index = std::find(m_matches.begin(), m_matches.end(),
-                                 find(index)) - m_matches.begin();
+        // drawLine() knows whether the item matches
+        search_index = m_search.size() ? 0 : m_matches.size();
 
     // don't highlight if moving, doesn't work with alpha on
     if (highlight && !m_moving) {
         highlightItem(index);
         if (search_index < (int)m_matches.size())
-            drawLine(index, m_type_ahead.stringSize());
+            drawLine(index);
         return;
     } else if (clear)
         m_frame.clearArea(item_x, item_y, item_w, item_h);
@@ -1308,7 +1330,7 @@ void Menu::clearItem(int index, bool clear, int search_index) {
                item_w, item_h);
 
     if (search_index < (int)m_matches.size())
-        drawLine(index, m_type_ahead.stringSize());
+        drawLine(index);
 }
 
 // Area must have been cleared before calling highlight
@@ -1358,7 +1380,7 @@ void Menu::highlightItem(int index) {
 void Menu::resetTypeAhead() {
     Menuitems vec = m_matches;
     Menuitems::iterator it = vec.begin();
-    m_type_ahead.reset();
+    m_search.clear();
     m_matches.clear();
 
     for (; it != vec.end(); ++it)
@@ -1370,13 +1392,13 @@ void Menu::drawTypeAheadItems() {
     for (size_t i = 0; i < m_matches.size(); i++)
         clearItem(m_matches[i]->getIndex(), true, m_matches.size());
 
-    m_matches = m_type_ahead.matched();
+    m_matches = m_search.matched();
     for (size_t j = 0; j < m_matches.size(); j++)
         clearItem(m_matches[j]->getIndex(), false, j);
 }
 
-// underline menuitem[index] with respect to matchstringsize size
-void Menu::drawLine(int index, int size){
+// underline the part of menuitem[index] that matches the search
+void Menu::drawLine(int index){
     if (!validIndex(index))
         return;
 
@@ -1395,7 +1417,10 @@ void Menu::drawLine(int index, int size){
     int item_y = (row * theme()->itemHeight());
 
     FbTk::MenuItem *item = find(index);
-    item->drawLine(m_frame, theme(), size, item_x, item_y, m_item_w);
+    size_t start, size;
+    if (item->isEnabled() && m_search.underline(*item, start, size))
+        item->drawLine(m_frame, theme(), start, size,
+                       item_x, item_y, m_item_w);
 }
 
 void Menu::hideShownMenu() {
@@ -33,7 +33,8 @@
 #include "EventHandler.hh"
 #include "MenuTheme.hh"
 #include "Timer.hh"
-#include "TypeAhead.hh"
+#include "RenderQueue.hh"
+#include "MenuSearch.hh"
 
 namespace FbTk {
 
@@ -199,13 +200,15 @@ private:
 
     typedef std::vector<MenuItem *> Menuitems;
     Menuitems menuitems;
-    TypeAhead<Menuitems, MenuItem *> m_type_ahead;
+    MenuSearch m_search;
     Menuitems m_matches;
 
     void resetTypeAhead();
     void drawTypeAheadItems();
-    void drawLine(int index, int size);
+    void drawLine(int index);
     void fixMenuItemIndices();
+    /// renders the menu while it is hidden, from the RenderQueue
+    void renderHidden();
 
     int m_screen_x, m_screen_y;
     unsigned int m_screen_width, m_screen_height;
@@ -256,6 +259,8 @@ private:
     static Menu *shown; ///< used for determining if there's a menu open at all
     static Menu *s_focused; ///< holds current input focused menu, so one can determine if a menu is focused
     bool m_need_update;
+    bool m_render_hidden; ///< updateMenu renders even though we're hidden
+    RenderQueue::Job m_render_job;
     Timer m_submenu_timer;
     Timer m_hide_timer;
 
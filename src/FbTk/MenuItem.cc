@@ -43,7 +43,8 @@ void MenuItem::click(int button, int time, unsigned int mods) {
 }
 
 void MenuItem::drawLine(FbDrawable &draw,
-                        const FbTk::ThemeProxy<MenuTheme> &theme, size_t size,
+                        const FbTk::ThemeProxy<MenuTheme> &theme,
+                        size_t start, size_t size,
                         int text_x, int text_y, unsigned int width) const {
 
     unsigned int height = theme->itemHeight();
@@ -58,7 +59,13 @@ void MenuItem::drawLine(FbDrawable &draw,
     int text_w = theme->frameFont().textWidth(label());
 
     const FbString& visual = m_label.visual();
-    BiDiString search_string(FbString(visual, 0, size > visual.size() ? visual.size() : size));
+    if (start > visual.size())
+        start = visual.size();
+    if (size > visual.size() - start)
+        size = visual.size() - start;
+    BiDiString before_string(FbString(visual, 0, start));
+    BiDiString search_string(FbString(visual, 0, start + size));
+    int before_string_w = theme->frameFont().textWidth(before_string);
     int search_string_w = theme->frameFont().textWidth(search_string);
 
     // pay attention to the text justification
@@ -77,7 +84,8 @@ void MenuItem::drawLine(FbDrawable &draw,
     // avoid drawing an ugly dot
     if (size != 0)
         draw.drawLine(theme->frameUnderlineGC().gc(),
-                      text_x, text_y, text_x + search_string_w, text_y);
+                      text_x + before_string_w, text_y,
+                      text_x + search_string_w, text_y);
 
 }
 
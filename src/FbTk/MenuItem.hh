@@ -114,11 +114,11 @@ public:
 
     // iType functions
     virtual void setIndex(int index) { m_index = index; }
-    virtual int getIndex() { return m_index; }
+    virtual int getIndex() const { return m_index; }
     const FbString &iTypeString() const { return m_label.visual(); }
     virtual void drawLine(FbDrawable &draw,
                       const FbTk::ThemeProxy<MenuTheme> &theme,
-                      size_t size,
+                      size_t start, size_t size,
                       int text_x, int text_y,
                       unsigned int width) const;
 
@@ -0,0 +1,212 @@
+// MenuSearch.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "MenuSearch.hh"
+#include "MenuItem.hh"
+#include "StringUtil.hh"
+
+#ifdef HAVE_CCTYPE
+  #include <cctype>
+#else
+  #include <ctype.h>
+#endif // HAVE_CCTYPE
+
+namespace {
+
+// only plain ascii is folded, so every byte keeps its position
+// in a multibyte label
+inline char lowerChar(char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? ch - 'A' + 'a' : ch;
+}
+
+} // end anonymous namespace
+
+namespace FbTk {
+
+MenuSearch::Mode MenuSearch::s_mode = MenuSearch::ITEMSTART;
+
+void MenuSearch::setMode(const std::string &mode) {
+    std::string m = StringUtil::toLower(mode);
+    if (m == "nowhere")
+        s_mode = NOWHERE;
+    else if (m == "somewhere")
+        s_mode = SOMEWHERE;
+    else if (m == "fuzzy")
+        s_mode = FUZZY;
+    else
+        s_mode = ITEMSTART;
+}
+
+void MenuSearch::add(char ch) {
+    if (s_mode == NOWHERE || m_items == 0 || !isprint(static_cast<unsigned char>(ch)))
+        return;
+
+    std::string pattern = m_pattern + lowerChar(ch);
+    Items result;
+
+    if (m_results.empty()) {
+        // whatever mode, a match has to contain the character,
+        // so the index already gives us all candidates
+        if (m_dirty)
+            buildIndex();
+        const std::vector<size_t> &candidates =
+            m_index[static_cast<unsigned char>(pattern[0])];
+        std::vector<size_t>::const_iterator it = candidates.begin();
+        for (; it != candidates.end(); ++it) {
+            MenuItem *item = (*m_items)[*it];
+            if (item->isEnabled() && match(m_lowered[*it], pattern))
+                result.push_back(item);
+        }
+    } else {
+        // a longer string only matches what the shorter one did
+        const Items &last = m_results.back();
+        Items::const_iterator it = last.begin();
+        for (; it != last.end(); ++it) {
+            if ((*it)->isEnabled() && match(lowered(**it), pattern))
+                result.push_back(*it);
+        }
+    }
+
+    if (result.empty())
+        return;
+
+    m_pattern = pattern;
+    m_results.push_back(result);
+}
+
+void MenuSearch::backspace() {
+    if (m_results.empty())
+        return;
+
+    m_results.pop_back();
+    m_pattern.erase(m_pattern.size() - 1);
+}
+
+void MenuSearch::clear() {
+    m_pattern.clear();
+    m_results.clear();
+}
+
+void MenuSearch::seek() {
+    if (s_mode != ITEMSTART || m_results.empty())
+        return;
+
+    const Items &last = m_results.back();
+    const std::string &first = lowered(*last[0]);
+    size_t common = first.size();
+    for (size_t i = 1; i < last.size() && common > m_pattern.size(); ++i) {
+        const std::string &label = lowered(*last[i]);
+        size_t n = 0;
+        while (n < common && n < label.size() && label[n] == first[n])
+            ++n;
+        common = n;
+    }
+
+    // one step per character, so backspace takes them back one by one
+    while (m_pattern.size() < common) {
+        m_pattern += first[m_pattern.size()];
+        m_results.push_back(m_results.back());
+    }
+}
+
+MenuSearch::Items MenuSearch::matched() const {
+    if (m_results.empty())
+        return m_items ? *m_items : Items();
+    return m_results.back();
+}
+
+bool MenuSearch::underline(const MenuItem &item,
+                           size_t &start, size_t &length) const {
+    if (m_pattern.empty())
+        return false;
+    return match(lowered(item), m_pattern, &start, &length);
+}
+
+void MenuSearch::buildIndex() const {
+    m_dirty = false;
+    m_lowered.clear();
+    m_index.assign(256, std::vector<size_t>());
+    if (m_items == 0)
+        return;
+
+    m_lowered.resize(m_items->size());
+    for (size_t i = 0; i < m_items->size(); ++i) {
+        const std::string &label = (*m_items)[i]->iTypeString();
+        std::string &lower = m_lowered[i];
+        lower.resize(label.size());
+        for (size_t c = 0; c < label.size(); ++c) {
+            lower[c] = lowerChar(label[c]);
+            std::vector<size_t> &items =
+                m_index[static_cast<unsigned char>(lower[c])];
+            if (items.empty() || items.back() != i)
+                items.push_back(i);
+        }
+    }
+}
+
+const std::string &MenuSearch::lowered(const MenuItem &item) const {
+    static const std::string empty;
+    if (m_dirty)
+        buildIndex();
+    size_t index = static_cast<size_t>(item.getIndex());
+    return index < m_lowered.size() ? m_lowered[index] : empty;
+}
+
+bool MenuSearch::match(const std::string &label, const std::string &pattern,
+                       size_t *start, size_t *length) const {
+    size_t first = 0, last = 0;
+
+    switch (s_mode) {
+    case ITEMSTART:
+        if (label.compare(0, pattern.size(), pattern) != 0)
+            return false;
+        last = pattern.size() - 1;
+        break;
+    case SOMEWHERE:
+        first = label.find(pattern);
+        if (first == std::string::npos)
+            return false;
+        last = first + pattern.size() - 1;
+        break;
+    case FUZZY: {
+        size_t pos = 0;
+        for (size_t i = 0; i < pattern.size(); ++i, ++pos) {
+            pos = label.find(pattern[i], pos);
+            if (pos == std::string::npos)
+                return false;
+            if (i == 0)
+                first = pos;
+        }
+        last = pos - 1;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    if (start)
+        *start = first;
+    if (length)
+        *length = last - first + 1;
+    return true;
+}
+
+} // end namespace FbTk
@@ -0,0 +1,94 @@
+// MenuSearch.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FBTK_MENUSEARCH_HH
+#define FBTK_MENUSEARCH_HH
+
+#include <vector>
+#include <string>
+
+namespace FbTk {
+
+class MenuItem;
+
+/**
+ * Type-ahead search over the items of a menu.
+ *
+ * The lower cased labels and a per character index of them are built
+ * when the first character is typed and kept until the menu changes.
+ * Every further character only looks at the items the previous one
+ * matched, so even menus with thousands of items stay interactive.
+ */
+class MenuSearch {
+public:
+    typedef std::vector<MenuItem *> Items;
+
+    enum Mode {
+        NOWHERE,   ///< no type-ahead at all
+        ITEMSTART, ///< the label starts with the typed string
+        SOMEWHERE, ///< the typed string is part of the label
+        FUZZY      ///< the typed characters appear in order in the label
+    };
+
+    /// set mode for all menus, from the value of session.menuSearch
+    static void setMode(const std::string &mode);
+    static Mode mode() { return s_mode; }
+
+    MenuSearch(): m_items(0), m_dirty(true) { }
+
+    void init(const Items &items) { m_items = &items; m_dirty = true; }
+
+    /// @return number of typed characters
+    size_t size() const { return m_pattern.size(); }
+    /// add a character, ignored if nothing would match anymore
+    void add(char ch);
+    void backspace();
+    void clear();
+    /// extend the search to what all matches have in common
+    void seek();
+    /// the labels changed, the index must be built again
+    void invalidate() { m_dirty = true; }
+
+    /// @return matching items in menu order, all items if nothing was typed
+    Items matched() const;
+    /// @return part of the label to underline for a matching item
+    bool underline(const MenuItem &item, size_t &start, size_t &length) const;
+
+private:
+    void buildIndex() const;
+    const std::string &lowered(const MenuItem &item) const;
+    bool match(const std::string &label, const std::string &pattern,
+               size_t *start = 0, size_t *length = 0) const;
+
+    const Items *m_items; ///< the menu items we are searching
+    std::string m_pattern;
+    std::vector<Items> m_results; ///< matches for each typed character
+
+    mutable bool m_dirty;
+    mutable std::vector<std::string> m_lowered;
+    mutable std::vector<std::vector<size_t> > m_index; ///< items per character
+
+    static Mode s_mode;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_MENUSEARCH_HH
@@ -114,7 +114,11 @@ void MultLayers::restack() {
     if (!isUpdatable())
         return;
 
-    Layer::restack(m_layers);
+    std::vector<Window> stack;
+    for (size_t i = 0; i < m_layers.size(); ++i)
+        m_layers[i]->extractWindows(stack);
+
+    m_stacking.restack(App::instance()->display(), stack);
 }
 
 int MultLayers::size() {
@@ -23,6 +23,8 @@
 #ifndef FBTK_MULTLAYERS_HH
 #define FBTK_MULTLAYERS_HH
 
+#include "StackingOrder.hh"
+
 #include <vector>
 #include <cstdlib> // size_t
 
@@ -61,11 +63,13 @@ public:
     void lock() { ++m_lock; }
     void unlock() { if (--m_lock == 0) restack(); }
 
-private:
+    /// brings the windows of all layers into order, unless locked
     void restack();
 
+private:
     std::vector<Layer *> m_layers;
     int m_lock;
+    StackingOrder m_stacking; ///< what the server was told last
 };
 
 }
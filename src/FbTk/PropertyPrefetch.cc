@@ -0,0 +1,329 @@
+// PropertyPrefetch.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#include "PropertyPrefetch.hh"
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#ifdef HAVE_CSTRING
+  #include <cstring>
+#else
+  #include <string.h>
+#endif
+#ifdef HAVE_CSTDLIB
+  #include <cstdlib>
+#else
+  #include <stdlib.h>
+#endif
+#include <vector>
+
+// Xlibint.h is needed to queue requests with async reply handlers, the
+// same way Xlib itself pipelines the requests of XGetWindowAttributes.
+// It defines min and max as macros, so it has to come last.
+#include <X11/Xlibint.h>
+#undef min
+#undef max
+
+namespace FbTk {
+
+PropertyPrefetch *PropertyPrefetch::s_active = 0;
+
+struct PropertyPrefetch::Reply {
+    Reply(Window win, Atom prop):
+        window(win), property(prop), sequence(0), status(BadImplementation),
+        type(None), format(0), nitems(0), bytes_after(0) {
+        handler.next = 0;
+        handler.handler = 0;
+        handler.data = 0;
+    }
+
+    /// size of one item in the data returned by XGetWindowProperty
+    size_t itemSize() const {
+        switch (format) {
+        case 16: return sizeof(short);
+        case 32: return sizeof(long);
+        default: return 1;
+        }
+    }
+
+    Window window;
+    Atom property;
+    unsigned long sequence;
+    /// Success once the reply arrived, anything else means "ask the server"
+    int status;
+    Atom type;
+    int format;
+    unsigned long nitems;
+    unsigned long bytes_after;
+    /// items in the layout XGetWindowProperty returns, 32 bit items are longs
+    std::vector<unsigned char> data;
+    _XAsyncHandler handler;
+};
+
+namespace {
+
+Bool handleReply(Display *dpy, xReply *rep, char *buf, int len, XPointer data) {
+    PropertyPrefetch::Reply *reply = reinterpret_cast<PropertyPrefetch::Reply *>(data);
+
+    if (dpy->last_request_read != reply->sequence)
+        return False;
+
+    // leave errors to the regular error handler, the property
+    // will be read again and fail the normal way
+    if (rep->generic.type == X_Error)
+        return False;
+
+    xGetPropertyReply replbuf;
+    xGetPropertyReply *prop_rep = reinterpret_cast<xGetPropertyReply *>(
+        _XGetAsyncReply(dpy, reinterpret_cast<char *>(&replbuf), rep, buf, len,
+                        (SIZEOF(xGetPropertyReply) - SIZEOF(xReply)) >> 2, False));
+
+    const unsigned long total = static_cast<unsigned long>(prop_rep->length) << 2;
+    const bool valid_format = prop_rep->format == 8 || prop_rep->format == 16 ||
+        prop_rep->format == 32;
+    unsigned long wire_size = 0;
+    if (prop_rep->propertyType != None && valid_format)
+        wire_size = prop_rep->nItems * (prop_rep->format / 8);
+
+    if (wire_size > total || (prop_rep->propertyType != None && !valid_format)) {
+        // malformed reply, throw it away and let the property be read again
+        _XGetAsyncData(dpy, 0, buf, len, SIZEOF(xGetPropertyReply), 0, total);
+        return True;
+    }
+
+    reply->type = prop_rep->propertyType;
+    reply->format = prop_rep->format;
+    reply->nitems = wire_size ? prop_rep->nItems : 0;
+    reply->bytes_after = prop_rep->bytesAfter;
+
+    std::vector<char> wire(wire_size);
+    _XGetAsyncData(dpy, wire_size ? &wire[0] : 0, buf, len,
+                   SIZEOF(xGetPropertyReply), wire_size, total);
+
+    reply->data.resize(reply->nitems * reply->itemSize());
+    if (reply->format == 8) {
+        if (wire_size)
+            memcpy(&reply->data[0], &wire[0], wire_size);
+    } else if (reply->format == 16) {
+        short *dest = reinterpret_cast<short *>(&reply->data[0]);
+        for (unsigned long i = 0; i < reply->nitems; ++i) {
+            CARD16 value;
+            memcpy(&value, &wire[i * 2], 2);
+            dest[i] = static_cast<short>(value);
+        }
+    } else if (reply->format == 32) {
+        long *dest = reinterpret_cast<long *>(&reply->data[0]);
+        for (unsigned long i = 0; i < reply->nitems; ++i) {
+            CARD32 value;
+            memcpy(&value, &wire[i * 4], 4);
+            // XGetWindowProperty sign extends 32 bit items as well
+            dest[i] = static_cast<long>(static_cast<INT32>(value));
+        }
+    }
+
+    reply->status = Success;
+    return True;
+}
+
+} // end anonymous namespace
+
+PropertyPrefetch::PropertyPrefetch(Display *disp, Window win):
+    m_display(disp), m_window(win), m_fetched(false),
+    m_prev(s_active) {
+    s_active = this;
+}
+
+PropertyPrefetch::~PropertyPrefetch() {
+    s_active = m_prev;
+    Replies::iterator it = m_replies.begin();
+    for (; it != m_replies.end(); ++it)
+        delete it->second;
+}
+
+void PropertyPrefetch::add(Window win, Atom prop) {
+    if (m_fetched || win == None || prop == None)
+        return;
+
+    Reply *&reply = m_replies[std::make_pair(win, prop)];
+    if (reply == 0)
+        reply = new Reply(win, prop);
+}
+
+void PropertyPrefetch::fetch() {
+    if (m_fetched || m_replies.empty())
+        return;
+    m_fetched = true;
+
+    Display *dpy = m_display;
+
+    LockDisplay(dpy);
+    Replies::iterator it = m_replies.begin();
+    for (; it != m_replies.end(); ++it) {
+        Reply &reply = *it->second;
+
+        xGetPropertyReq *req;
+        GetReq(GetProperty, req);
+        req->window = reply.window;
+        req->property = reply.property;
+        req->type = AnyPropertyType;
+        req->c_delete = False;
+        req->longOffset = 0;
+        // same limit as XGetTextProperty, large enough for _NET_WM_ICON
+        req->longLength = 1000000;
+
+        reply.sequence = dpy->request;
+        reply.handler.next = dpy->async_handlers;
+        reply.handler.handler = handleReply;
+        reply.handler.data = reinterpret_cast<XPointer>(&reply);
+        dpy->async_handlers = &reply.handler;
+    }
+    UnlockDisplay(dpy);
+    SyncHandle();
+
+    // one round trip for all of them
+    XSync(dpy, False);
+
+    LockDisplay(dpy);
+    for (it = m_replies.begin(); it != m_replies.end(); ++it)
+        DeqAsyncHandler(dpy, &it->second->handler);
+    UnlockDisplay(dpy);
+}
+
+PropertyPrefetch::Reply *PropertyPrefetch::find(Window win, Atom prop) const {
+    Replies::const_iterator it = m_replies.find(std::make_pair(win, prop));
+    return it != m_replies.end() ? it->second : 0;
+}
+
+PropertyPrefetch::Reply *PropertyPrefetch::findActive(Window win, Atom prop) {
+    // the innermost prefetch has the most recent value
+    for (PropertyPrefetch *p = s_active; p != 0; p = p->m_prev) {
+        if (!p->m_fetched)
+            continue;
+        Reply *reply = p->find(win, prop);
+        if (reply == 0)
+            continue;
+        if (reply->status == Success && reply->bytes_after == 0)
+            return reply;
+        return 0;
+    }
+    return 0;
+}
+
+void PropertyPrefetch::invalidate(Window win, Atom prop) {
+    for (PropertyPrefetch *p = s_active; p != 0; p = p->m_prev) {
+        if (Reply *reply = p->find(win, prop))
+            reply->status = BadImplementation;
+    }
+}
+
+int PropertyPrefetch::getProperty(Display *disp, Window win, Atom prop,
+                                  long long_offset, long long_length,
+                                  Bool do_delete, Atom req_type,
+                                  Atom *actual_type_return,
+                                  int *actual_format_return,
+                                  unsigned long *nitems_return,
+                                  unsigned long *bytes_after_return,
+                                  unsigned char **prop_return) {
+
+    Reply *reply = do_delete ? 0 : findActive(win, prop);
+    if (reply == 0 || long_offset < 0 || long_length < 0) {
+        if (do_delete)
+            invalidate(win, prop);
+        return XGetWindowProperty(disp, win, prop, long_offset, long_length,
+                                  do_delete, req_type, actual_type_return,
+                                  actual_format_return, nitems_return,
+                                  bytes_after_return, prop_return);
+    }
+
+    // answer the way the server would have, see GetProperty in the protocol
+    *prop_return = 0;
+    *actual_type_return = reply->type;
+    *actual_format_return = reply->format;
+    *nitems_return = 0;
+    *bytes_after_return = 0;
+
+    if (reply->type == None)
+        return Success;
+
+    const unsigned long wire_item = reply->format / 8;
+    const unsigned long total = reply->nitems * wire_item;
+
+    unsigned long first = 0;
+    unsigned long count = 0;
+    if (req_type != AnyPropertyType && req_type != reply->type) {
+        *bytes_after_return = total;
+    } else {
+        const unsigned long offset = static_cast<unsigned long>(long_offset) * 4;
+        if (offset > total)
+            return BadValue;
+        unsigned long length = total - offset;
+        if (static_cast<unsigned long>(long_length) < (length + 3) / 4)
+            length = static_cast<unsigned long>(long_length) * 4;
+        first = offset / wire_item;
+        count = length / wire_item;
+        *nitems_return = count;
+        *bytes_after_return = total - offset - count * wire_item;
+    }
+
+    // Xlib always hands out a terminated buffer for an existing property
+    const size_t size = count * reply->itemSize();
+    unsigned char *data = static_cast<unsigned char *>(malloc(size + 1));
+    if (data == 0)
+        return BadAlloc;
+    if (size)
+        memcpy(data, &reply->data[first * reply->itemSize()], size);
+    data[size] = '\0';
+    *prop_return = data;
+
+    return Success;
+}
+
+Status PropertyPrefetch::getTextProperty(Display *disp, Window win,
+                                         XTextProperty *text_prop_return,
+                                         Atom prop) {
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    unsigned char *data = 0;
+
+    if (getProperty(disp, win, prop, 0, 1000000, False, AnyPropertyType,
+                    &type, &format, &nitems, &bytes_after, &data) == Success &&
+        type != None) {
+        text_prop_return->value = data;
+        text_prop_return->encoding = type;
+        text_prop_return->format = format;
+        text_prop_return->nitems = nitems;
+        return True;
+    }
+
+    if (data)
+        XFree(data);
+    text_prop_return->value = 0;
+    text_prop_return->encoding = None;
+    text_prop_return->format = 0;
+    text_prop_return->nitems = 0;
+    return False;
+}
+
+} // end namespace FbTk
@@ -0,0 +1,100 @@
+// PropertyPrefetch.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef FBTK_PROPERTYPREFETCH_HH
+#define FBTK_PROPERTYPREFETCH_HH
+
+#include "NotCopyable.hh"
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <map>
+#include <utility>
+
+namespace FbTk {
+
+/// Reads a batch of window properties in one round trip
+/**
+   Usage: create a PropertyPrefetch for a window, add() the properties
+   that are about to be read and call fetch().  Properties of several
+   windows can be fetched together with add(Window, Atom).  All GetProperty requests
+   are sent at once and their replies collected with a single XSync.
+   While the object is alive, getProperty() and getTextProperty() answer
+   reads of the prefetched properties from the replies instead of asking
+   the server again, so code written against XGetWindowProperty does not
+   need to know about the prefetch.
+
+   Properties that are changed or deleted through FbWindow are dropped
+   from the prefetch, so a later read sees the new value.
+*/
+class PropertyPrefetch: private NotCopyable {
+public:
+    explicit PropertyPrefetch(Display *disp, Window win = None);
+    ~PropertyPrefetch();
+
+    /// request @a prop of the window given to the constructor with the next fetch()
+    void add(Atom prop) { add(m_window, prop); }
+    /// request @a prop of @a win with the next fetch()
+    void add(Window win, Atom prop);
+    /// sends the requests for all added properties and waits for the replies
+    void fetch();
+
+    /// same as XGetWindowProperty, but uses prefetched replies if there are any
+    static int getProperty(Display *disp, Window win, Atom prop,
+                           long long_offset, long long_length,
+                           Bool do_delete, Atom req_type,
+                           Atom *actual_type_return,
+                           int *actual_format_return,
+                           unsigned long *nitems_return,
+                           unsigned long *bytes_after_return,
+                           unsigned char **prop_return);
+    /// same as XGetTextProperty, but uses prefetched replies if there are any
+    static Status getTextProperty(Display *disp, Window win,
+                                  XTextProperty *text_prop_return, Atom prop);
+
+    /// forget a prefetched value, call this when a property is changed
+    static void invalidate(Window win, Atom prop);
+
+    /// one pending or received property, only used internally
+    struct Reply;
+
+private:
+
+    Reply *find(Window win, Atom prop) const;
+    static Reply *findActive(Window win, Atom prop);
+
+    /// indexed, the startup prefetch holds a couple per root child
+    typedef std::map<std::pair<Window, Atom>, Reply *> Replies;
+
+    Display *m_display;
+    Window m_window;
+    Replies m_replies;
+    bool m_fetched;
+
+    /// prefetches are nested when a window is managed while managing another
+    PropertyPrefetch *m_prev;
+    static PropertyPrefetch *s_active;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_PROPERTYPREFETCH_HH
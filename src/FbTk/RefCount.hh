@@ -59,9 +59,10 @@ private:
 
 // implementation
 
+// a null RefCount doesn't need a counter, so we don't allocate one
+
 template <typename Pointer>
-RefCount<Pointer>::RefCount():m_data(0), m_refcount(new unsigned int(0)) {
-    incRefCount(); // it really counts how many things are storing m_refcount
+RefCount<Pointer>::RefCount():m_data(0), m_refcount(0) {
 }
 
 template <typename Pointer>
@@ -73,7 +74,7 @@ RefCount<Pointer>::RefCount(const RefCount<Pointer2> &copy):
 }
 
 template <typename Pointer>
-RefCount<Pointer>::RefCount(Pointer *p):m_data(p), m_refcount(new unsigned int(0)) {
+RefCount<Pointer>::RefCount(Pointer *p):m_data(p), m_refcount(p ? new unsigned int(0) : 0) {
     incRefCount();
 }
 
@@ -102,7 +103,7 @@ template <typename Pointer>
 void RefCount<Pointer>::reset(Pointer *p) {
     decRefCount();
     m_data = p; // set data pointer
-    m_refcount = new unsigned int(0); // create new counter
+    m_refcount = p ? new unsigned int(0) : 0; // create new counter
     incRefCount();
 }
 
@@ -0,0 +1,120 @@
+// RenderQueue.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#include "RenderQueue.hh"
+#include "App.hh"
+#include "Timer.hh"
+
+#include <list>
+
+namespace {
+
+typedef std::list<FbTk::RenderQueue::Job *> Jobs;
+
+Jobs s_jobs;
+
+// how long a slice may take, in microseconds
+const long SLICE_USEC = 5000;
+
+long usecSince(const timeval &start) {
+    timeval now;
+    gettimeofday(&now, 0);
+    return (now.tv_sec - start.tv_sec) * 1000000L + (now.tv_usec - start.tv_usec);
+}
+
+} // end anonymous namespace
+
+namespace FbTk {
+
+TimeStat RenderQueue::s_job_stat;
+
+void RenderQueue::Job::schedule() {
+    if (m_scheduled || !m_handler)
+        return;
+
+    m_scheduled = true;
+    s_jobs.push_back(this);
+    RenderQueue::startTimer();
+}
+
+void RenderQueue::Job::cancel() {
+    if (!m_scheduled)
+        return;
+
+    m_scheduled = false;
+    s_jobs.remove(this);
+    if (s_jobs.empty())
+        RenderQueue::timer().stop();
+}
+
+void RenderQueue::flush() {
+    while (!s_jobs.empty())
+        runJob(*s_jobs.front());
+}
+
+size_t RenderQueue::numPending() {
+    return s_jobs.size();
+}
+
+void RenderQueue::runJob(Job &job) {
+    // off the queue first, the job may well schedule itself again
+    job.cancel();
+    StatTimer stat_timer(s_job_stat);
+    (*job.m_handler)();
+}
+
+void RenderQueue::runSlice() {
+    Display *disp = App::instance()->display();
+    timeval start;
+    gettimeofday(&start, 0);
+
+    // the last jobs might have been destroyed since the timer started
+    if (s_jobs.empty())
+        return;
+
+    do {
+        runJob(*s_jobs.front());
+    } while (!s_jobs.empty() && usecSince(start) < SLICE_USEC &&
+             XPending(disp) == 0);
+
+    if (!s_jobs.empty())
+        startTimer();
+}
+
+void RenderQueue::startTimer() {
+    if (!timer().isTiming())
+        timer().start();
+}
+
+Timer &RenderQueue::timer() {
+    // never destroyed, the timer list might be gone by then
+    static Timer *timer = 0;
+    if (timer == 0) {
+        timer = new Timer();
+        timer->setTimeout(0);
+        timer->fireOnce(true);
+        timer->setFunctor(&RenderQueue::runSlice);
+    }
+    return *timer;
+}
+
+} // end namespace FbTk
@@ -0,0 +1,93 @@
+// RenderQueue.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef FBTK_RENDERQUEUE_HH
+#define FBTK_RENDERQUEUE_HH
+
+#include "NotCopyable.hh"
+#include "RefCount.hh"
+#include "Slot.hh"
+#include "Stats.hh"
+
+#include <cstddef>
+
+namespace FbTk {
+
+class Timer;
+
+/// Renders things nobody is looking at yet, while the X server is idle
+/**
+   Off-screen work, like hidden menus or the variant of a decoration
+   that isn't shown, gets queued as a Job instead of being rendered
+   right away.  The queue runs from a zero timeout timer, which only
+   fires when no X events are pending, and works in slices of a few
+   milliseconds.  It stops between two jobs as soon as an event arrives,
+   so an interactive action never waits for more than a single job.
+
+   Visible work doesn't go through the queue, it is rendered directly
+   and so always comes first.  A job therefore has to check whether
+   there still is something to do when it runs.
+*/
+class RenderQueue {
+public:
+    /// some work for the queue, it leaves the queue when destroyed
+    class Job: private NotCopyable {
+    public:
+        Job(): m_scheduled(false) { }
+        ~Job() { cancel(); }
+
+        template<typename Functor>
+        void setFunctor(const Functor &functor) {
+            m_handler.reset(new SlotImpl<Functor, void>(functor));
+        }
+
+        /// queues the job, unless it is queued already
+        void schedule();
+        /// takes the job out of the queue
+        void cancel();
+        bool isScheduled() const { return m_scheduled; }
+
+    private:
+        friend class RenderQueue;
+        RefCount<Slot<void> > m_handler;
+        bool m_scheduled;
+    };
+
+    /// runs all queued jobs right away
+    static void flush();
+
+    static size_t numPending();
+    /// time spent running jobs
+    static const TimeStat &jobStat() { return s_job_stat; }
+
+private:
+    static void runSlice();
+    static void runJob(Job &job);
+    static void startTimer();
+    static Timer &timer();
+
+    static TimeStat s_job_stat;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_RENDERQUEUE_HH
@@ -0,0 +1,61 @@
+// RequestCounter.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#include "RequestCounter.hh"
+
+// Xlibint.h is needed to look at the sequence numbers of the display
+#include <X11/Xlibint.h>
+
+namespace FbTk {
+
+bool RequestCounter::s_enabled = false;
+unsigned long RequestCounter::s_round_trips = 0;
+unsigned long RequestCounter::s_last_request_read = 0;
+int (*RequestCounter::s_prev_after_function)(Display *) = 0;
+
+void RequestCounter::enable(Display *disp) {
+    if (s_enabled)
+        return;
+
+    s_enabled = true;
+    s_last_request_read = disp->last_request_read;
+    s_prev_after_function = XSetAfterFunction(disp, afterFunction);
+}
+
+unsigned long RequestCounter::requests(Display *disp) {
+    return NextRequest(disp) - 1;
+}
+
+// Xlib calls this at the end of every function that sent a request. A
+// function that waited for a reply leaves the display with the reply
+// of its own, last, request read.
+int RequestCounter::afterFunction(Display *disp) {
+    if (disp->last_request_read != s_last_request_read &&
+        disp->last_request_read == disp->request)
+        ++s_round_trips;
+    s_last_request_read = disp->last_request_read;
+
+    // e.g. the one of XSynchronize
+    return s_prev_after_function ? s_prev_after_function(disp) : 0;
+}
+
+} // end namespace FbTk
@@ -0,0 +1,59 @@
+// RequestCounter.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef FBTK_REQUESTCOUNTER_HH
+#define FBTK_REQUESTCOUNTER_HH
+
+#include <X11/Xlib.h>
+
+namespace FbTk {
+
+/// Counts the X requests and round trips of a display connection
+/**
+   The number of requests is known to Xlib anyway and is always
+   available.  Round trips are counted by an Xlib after function, which
+   only gets installed by enable(), so nothing is spent on them unless
+   somebody asked for the numbers.
+*/
+class RequestCounter {
+public:
+    /// starts counting round trips on @a disp
+    static void enable(Display *disp);
+    static bool isEnabled() { return s_enabled; }
+
+    /// @return number of requests sent on @a disp so far
+    static unsigned long requests(Display *disp);
+    /// @return number of round trips since enable()
+    static unsigned long roundTrips() { return s_round_trips; }
+
+private:
+    static int afterFunction(Display *disp);
+
+    static bool s_enabled;
+    static unsigned long s_round_trips;
+    static unsigned long s_last_request_read;
+    static int (*s_prev_after_function)(Display *);
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_REQUESTCOUNTER_HH
@@ -0,0 +1,259 @@
+// ShmImage.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#include "ShmImage.hh"
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#ifdef HAVE_XSHM
+#include <X11/Xutil.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+
+#include <algorithm>
+#include <vector>
+#endif // HAVE_XSHM
+
+namespace FbTk {
+
+bool ShmImage::s_enabled = true;
+
+#ifdef HAVE_XSHM
+
+namespace {
+
+struct Segment {
+    XShmSegmentInfo info;
+    size_t size;
+    unsigned long last_request; ///< last request that reads from it
+    bool in_use;
+};
+
+typedef std::vector<Segment *> Pool;
+
+Pool s_pool;
+Display *s_display = 0;
+enum { SHM_UNKNOWN, SHM_YES, SHM_NO } s_state = SHM_UNKNOWN;
+
+// below this, the socket is just as fast
+const size_t MIN_IMAGE_SIZE = 64 * 1024;
+const size_t MAX_SEGMENTS = 4;
+// bigger segments, like the ones for a wallpaper, aren't kept around
+const size_t MAX_KEPT_SIZE = 4 * 1024 * 1024;
+
+// X_ShmAttach, shmproto.h isn't installed everywhere
+const unsigned char SHM_ATTACH_REQUEST = 1;
+
+int s_shm_opcode = 0;
+bool s_attach_failed = false;
+XErrorHandler s_old_handler = 0;
+
+int handleAttachError(Display *disp, XErrorEvent *error) {
+    if (error->request_code == s_shm_opcode &&
+        error->minor_code == SHM_ATTACH_REQUEST) {
+        s_attach_failed = true;
+        return 0;
+    }
+    // not ours, e.g. a window that went away meanwhile
+    return s_old_handler != 0 ? s_old_handler(disp, error) : 0;
+}
+
+void freeSegment(Segment *seg) {
+    // the server detaches after it handled all previous requests,
+    // so this is fine even if it still has to read from it
+    XShmDetach(s_display, &seg->info);
+    shmdt(seg->info.shmaddr);
+    delete seg;
+}
+
+Segment *newSegment(size_t size) {
+    Segment *seg = new Segment;
+    seg->size = size;
+    seg->last_request = 0;
+    seg->in_use = false;
+    seg->info.readOnly = False;
+    seg->info.shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (seg->info.shmid < 0) {
+        delete seg;
+        return 0;
+    }
+
+    seg->info.shmaddr = static_cast<char *>(shmat(seg->info.shmid, 0, 0));
+    if (seg->info.shmaddr == reinterpret_cast<char *>(-1)) {
+        shmctl(seg->info.shmid, IPC_RMID, 0);
+        delete seg;
+        return 0;
+    }
+
+    // the attach fails for a server on another machine, which the
+    // extension can't tell us beforehand
+    s_attach_failed = false;
+    s_old_handler = XSetErrorHandler(handleAttachError);
+    XShmAttach(s_display, &seg->info);
+    XSync(s_display, False);
+    XSetErrorHandler(s_old_handler);
+    s_old_handler = 0;
+
+    // gets removed as soon as both of us detached
+    shmctl(seg->info.shmid, IPC_RMID, 0);
+
+    if (s_attach_failed) {
+        s_state = SHM_NO;
+        shmdt(seg->info.shmaddr);
+        delete seg;
+        return 0;
+    }
+
+    return seg;
+}
+
+/// @return a segment of at least @a size bytes, or 0
+Segment *getSegment(size_t size) {
+    Segment *busy = 0, *small = 0;
+    for (Pool::iterator it = s_pool.begin(); it != s_pool.end(); ++it) {
+        Segment *seg = *it;
+        if (seg->in_use)
+            continue;
+        if (seg->size < size)
+            small = seg;
+        else if (seg->last_request > LastKnownRequestProcessed(s_display))
+            busy = seg;
+        else
+            return seg;
+    }
+
+    if (busy != 0) {
+        // waiting for the server is still cheaper than a new segment
+        XSync(s_display, False);
+        return busy;
+    }
+
+    if (s_pool.size() < MAX_SEGMENTS || small != 0) {
+        if (s_pool.size() >= MAX_SEGMENTS) {
+            // make room for a bigger one
+            s_pool.erase(std::find(s_pool.begin(), s_pool.end(), small));
+            freeSegment(small);
+        }
+        Segment *seg = newSegment(size);
+        if (seg != 0)
+            s_pool.push_back(seg);
+        return seg;
+    }
+
+    return 0;
+}
+
+Segment *findSegment(XImage *image) {
+    for (Pool::iterator it = s_pool.begin(); it != s_pool.end(); ++it) {
+        if (reinterpret_cast<char *>(&(*it)->info) == image->obdata)
+            return *it;
+    }
+    return 0;
+}
+
+void releaseSegment(XImage *image) {
+    Segment *seg = findSegment(image);
+    image->data = 0;
+    XDestroyImage(image);
+    if (seg == 0)
+        return;
+
+    seg->in_use = false;
+    if (seg->size > MAX_KEPT_SIZE) {
+        s_pool.erase(std::find(s_pool.begin(), s_pool.end(), seg));
+        freeSegment(seg);
+    }
+}
+
+} // end anonymous namespace
+
+XImage *ShmImage::create(Display *disp, Visual *visual, int depth,
+                         unsigned int width, unsigned int height) {
+    if (!s_enabled || s_state == SHM_NO)
+        return 0;
+
+    if (s_state == SHM_UNKNOWN) {
+        s_display = disp;
+        int event_base, error_base;
+        s_state = XShmQueryExtension(disp) &&
+                  XQueryExtension(disp, "MIT-SHM", &s_shm_opcode,
+                                  &event_base, &error_base) ? SHM_YES : SHM_NO;
+        if (s_state == SHM_NO)
+            return 0;
+    }
+
+    if (disp != s_display)
+        return 0;
+
+    XShmSegmentInfo info;
+    XImage *image = XShmCreateImage(disp, visual, depth, ZPixmap, 0, &info,
+                                    width, height);
+    if (image == 0)
+        return 0;
+
+    size_t size = image->bytes_per_line * height;
+    Segment *seg = 0;
+    if (size >= MIN_IMAGE_SIZE)
+        seg = getSegment(size);
+
+    if (seg == 0) {
+        XDestroyImage(image);
+        return 0;
+    }
+
+    seg->in_use = true;
+    image->obdata = reinterpret_cast<char *>(&seg->info);
+    image->data = seg->info.shmaddr;
+    return image;
+}
+
+void ShmImage::put(Drawable drawable, GC gc, XImage *image) {
+    XShmPutImage(s_display, drawable, gc, image, 0, 0, 0, 0,
+                 image->width, image->height, False);
+
+    Segment *seg = findSegment(image);
+    if (seg != 0)
+        seg->last_request = NextRequest(s_display) - 1;
+    releaseSegment(image);
+}
+
+void ShmImage::destroy(XImage *image) {
+    releaseSegment(image);
+}
+
+#else // !HAVE_XSHM
+
+XImage *ShmImage::create(Display *, Visual *, int,
+                         unsigned int, unsigned int) {
+    return 0;
+}
+
+void ShmImage::put(Drawable, GC, XImage *) { }
+
+void ShmImage::destroy(XImage *) { }
+
+#endif // HAVE_XSHM
+
+} // end namespace FbTk
@@ -0,0 +1,63 @@
+// ShmImage.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef FBTK_SHMIMAGE_HH
+#define FBTK_SHMIMAGE_HH
+
+#include <X11/Xlib.h>
+
+namespace FbTk {
+
+/// Uploads XImages through shared memory (MIT-SHM)
+/**
+   The image gets rendered straight into a shared memory segment, so
+   XShmPutImage only has to tell the server where the pixels are instead
+   of copying all of them through the socket.  Segments are kept in a
+   small pool.  The server might still read from a segment after the put
+   returned, so a segment is only reused once the server got past that
+   request.
+
+   Without the extension, on a display that can't share memory with us
+   (i.e. a remote one) and for small images, create() returns 0 and the
+   caller falls back to XCreateImage and XPutImage.
+*/
+class ShmImage {
+public:
+    /// @return an image with its data in a shared segment, or 0
+    static XImage *create(Display *disp, Visual *visual, int depth,
+                          unsigned int width, unsigned int height);
+    /// puts the whole image and gives its segment back to the pool
+    static void put(Drawable drawable, GC gc, XImage *image);
+    /// gives the segment back to the pool without putting it
+    static void destroy(XImage *image);
+
+    /// allows switching it off, to compare both ways
+    static void setEnabled(bool enabled) { s_enabled = enabled; }
+    static bool isEnabled() { return s_enabled; }
+
+private:
+    static bool s_enabled;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_SHMIMAGE_HH
@@ -24,10 +24,9 @@
 
 #include "RefCount.hh"
 #include "Slot.hh"
+#include "SmallVector.hh"
 #include <algorithm>
-#include <list>
-#include <map>
-#include <set>
+#include <utility>
 
 namespace FbTk {
 
@@ -38,11 +37,13 @@ namespace SigImpl {
  * Parent class for all \c Signal template classes.
  * It handles the disconnect and holds all the slots. The connect must be
  * handled by the child class so it can do the type checking.
+ *
+ * Most signals have only a handful of slots, so they are kept inline
+ * (see SmallVector) and connecting or emitting doesn't allocate.
  */
 class SignalHolder {
 protected:
     typedef RefCount<SlotBase> SlotPtr;
-    typedef std::list<SlotPtr> SlotList;
 
 public:
     /// Special tracker interface used by SignalTracker.
@@ -53,11 +54,10 @@ public:
         virtual void disconnect(SignalHolder& signal) = 0;
     };
 
-    typedef SlotList::iterator Iterator;
-    typedef Iterator SlotID;
-    typedef SlotList::const_iterator ConstIterator;
+    /// identifies a connection, 0 is never used
+    typedef unsigned int SlotID;
 
-    SignalHolder() : m_emitting(0) {}
+    SignalHolder() : m_emitting(0), m_last_id(0) {}
 
     ~SignalHolder() {
         // Disconnect this holder from all trackers.
@@ -69,56 +69,81 @@ public:
     }
 
     /// Remove a specific slot \c id from this signal
-    void disconnect(SlotID slotIt) const {
-        if(m_emitting) {
-            // if we are emitting, we must not erase the actual element, as that would
-            // invalidate iterators in the emit() function
-            *slotIt = SlotPtr();
-        } else
-            m_slots.erase( slotIt );
+    void disconnect(SlotID id) const {
+        for (SlotList::iterator it = m_slots.begin(); it != m_slots.end(); ++it) {
+            if (it->id != id)
+                continue;
+
+            if(m_emitting) {
+                // if we are emitting, we must not erase the actual element,
+                // as that would move the slots emit() is working on; and
+                // the slot might be the one being called right now
+                it->id = 0;
+            } else
+                m_slots.erase(it);
+            return;
+        }
     }
 
 
     /// Removes all slots connected to this
     void clear() {
-        if(m_emitting)
-            std::fill(m_slots.begin(), m_slots.end(), SlotPtr());
-        else
+        if(m_emitting) {
+            for (SlotList::iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+                it->id = 0;
+        } else
             m_slots.clear();
     }
 
     void connectTracker(SignalHolder::Tracker& tracker) const {
-        m_trackers.insert(&tracker);
+        if (std::find(m_trackers.begin(), m_trackers.end(), &tracker) == m_trackers.end())
+            m_trackers.push_back(&tracker);
     }
 
     void disconnectTracker(SignalHolder::Tracker& tracker) const {
-        m_trackers.erase(&tracker);
+        Trackers::iterator it = std::find(m_trackers.begin(), m_trackers.end(), &tracker);
+        if (it != m_trackers.end())
+            m_trackers.erase(it);
     }
 
 protected:
-    ConstIterator begin() const { return m_slots.begin(); }
-    ConstIterator end() const { return m_slots.end(); }
-
-    Iterator begin() { return m_slots.begin(); }
-    Iterator end() { return m_slots.end(); }
+    /// number of connections, including the ones disconnected during emit
+    size_t numSlots() const { return m_slots.size(); }
+    /// @return slot number @a i or 0 if it was disconnected
+    SlotBase *slot(size_t i) const {
+        return m_slots[i].id ? m_slots[i].slot.get() : 0;
+    }
 
     /// Connect a slot to this signal. Must only be called by child classes.
     SlotID connect(const SlotPtr& slot) const {
-        return m_slots.insert(m_slots.end(), slot);
+        if (++m_last_id == 0) // wrapped around, skip 0
+            ++m_last_id;
+        m_slots.push_back(Entry(m_last_id, slot));
+        return m_last_id;
     }
 
     void begin_emitting() { ++m_emitting; }
     void end_emitting() {
         if(--m_emitting == 0) {
             // remove elements which belonged slots that detached themselves
-            m_slots.erase(std::remove(m_slots.begin(), m_slots.end(), SlotPtr()), m_slots.end());
+            m_slots.erase(std::remove_if(m_slots.begin(), m_slots.end(), isDisconnected),
+                          m_slots.end());
         }
     }
 private:
-    typedef std::set<Tracker*> Trackers;
+    struct Entry {
+        Entry(SlotID the_id, const SlotPtr &the_slot): id(the_id), slot(the_slot) { }
+        SlotID id; ///< 0 if disconnected during emit
+        SlotPtr slot;
+    };
+    static bool isDisconnected(const Entry &entry) { return entry.id == 0; }
+
+    typedef SmallVector<Entry, 4> SlotList;
+    typedef SmallVector<Tracker*, 2> Trackers;
     mutable SlotList m_slots; ///< all slots connected to a signal
     mutable Trackers m_trackers; ///< all instances that tracks this signal.
     unsigned m_emitting;
+    mutable SlotID m_last_id;
 };
 
 } // namespace SigImpl
@@ -130,9 +155,10 @@ class Signal: public SigImpl::SignalHolder {
 public:
     void emit(Arg1 arg1, Arg2 arg2, Arg3 arg3) {
         begin_emitting();
-        for ( Iterator it = begin(); it != end(); ++it ) {
-            if(*it)
-                static_cast<Slot<void, Arg1, Arg2, Arg3> &>(**it)(arg1, arg2, arg3);
+        // slots connected while emitting get called too
+        for (size_t i = 0; i < numSlots(); ++i) {
+            if (SigImpl::SlotBase *s = slot(i))
+                static_cast<Slot<void, Arg1, Arg2, Arg3> &>(*s)(arg1, arg2, arg3);
         }
         end_emitting();
     }
@@ -155,9 +181,10 @@ class Signal<Arg1, Arg2, SigImpl::EmptyArg>: public SigImpl::SignalHolder {
 public:
     void emit(Arg1 arg1, Arg2 arg2) {
         begin_emitting();
-        for ( Iterator it = begin(); it != end(); ++it ) {
-            if(*it)
-                static_cast<Slot<void, Arg1, Arg2> &>(**it)(arg1, arg2);
+        // slots connected while emitting get called too
+        for (size_t i = 0; i < numSlots(); ++i) {
+            if (SigImpl::SlotBase *s = slot(i))
+                static_cast<Slot<void, Arg1, Arg2> &>(*s)(arg1, arg2);
         }
         end_emitting();
     }
@@ -180,9 +207,10 @@ class Signal<Arg1, SigImpl::EmptyArg, SigImpl::EmptyArg>: public SigImpl::Signal
 public:
     void emit(Arg1 arg) {
         begin_emitting();
-        for ( Iterator it = begin(); it != end(); ++it ) {
-            if(*it)
-                static_cast<Slot<void, Arg1> &>(**it)(arg);
+        // slots connected while emitting get called too
+        for (size_t i = 0; i < numSlots(); ++i) {
+            if (SigImpl::SlotBase *s = slot(i))
+                static_cast<Slot<void, Arg1> &>(*s)(arg);
         }
         end_emitting();
     }
@@ -205,9 +233,10 @@ class Signal<SigImpl::EmptyArg, SigImpl::EmptyArg, SigImpl::EmptyArg>: public Si
 public:
     void emit() {
         begin_emitting();
-        for ( Iterator it = begin(); it != end(); ++it ) {
-            if(*it)
-                static_cast<Slot<void> &>(**it)();
+        // slots connected while emitting get called too
+        for (size_t i = 0; i < numSlots(); ++i) {
+            if (SigImpl::SlotBase *s = slot(i))
+                static_cast<Slot<void> &>(*s)();
         }
         end_emitting();
     }
@@ -231,9 +260,11 @@ public:
 class SignalTracker: public SigImpl::SignalHolder::Tracker {
 public:
     /// Internal type, do not use.
-    typedef std::map<const SigImpl::SignalHolder*,
-                     SigImpl::SignalHolder::SlotID> Connections;
-    typedef Connections::iterator TrackID; ///< \c ID type for join/leave.
+    typedef std::pair<const SigImpl::SignalHolder*,
+                      SigImpl::SignalHolder::SlotID> Connection;
+    /// Internal type, do not use. Sorted by signal.
+    typedef SmallVector<Connection, 4> Connections;
+    typedef const SigImpl::SignalHolder *TrackID; ///< \c ID type for join/leave.
 
     ~SignalTracker() {
         leaveAll();
@@ -253,25 +284,28 @@ public:
     joinSlot(const Signal<Arg1, Arg2, Arg3> &sig,
             const RefCount<Slot<void, Arg1, Arg2, Arg3> > &slot) {
 
-        ValueType value = ValueType(&sig, sig.connectSlot(slot));
-        std::pair<TrackID, bool> ret = m_connections.insert(value);
-        if ( !ret.second ) {
-            // failed to insert this functor
-            sig.disconnect(value.second);
-        }
+        Iterator it = findConnection(&sig);
+        // only one connection per signal
+        if (it != m_connections.end() && it->first == &sig)
+            return &sig;
 
+        m_connections.insert(it, Connection(&sig, sig.connectSlot(slot)));
         sig.connectTracker(*this);
 
-        return ret.first;
+        return &sig;
     }
 
     /// Leave tracking for a signal
-    /// @param id the \c id from the previous \c join 
-   void leave(TrackID id) {
-       // keep temporary, while disconnecting we can
-       // in some strange cases get a call to this again
-        ValueType tmp = *id;
-        m_connections.erase(id);
+    /// @param id the \c id from the previous \c join
+    void leave(TrackID id) {
+        Iterator it = findConnection(id);
+        if (it == m_connections.end() || it->first != id)
+            return;
+
+        // keep temporary, while disconnecting we can
+        // in some strange cases get a call to this again
+        Connection tmp = *it;
+        m_connections.erase(it);
         tmp.first->disconnect(tmp.second);
         tmp.first->disconnectTracker(*this);
     }
@@ -280,29 +314,38 @@ public:
     /// @param sig the signal to leave
     template <typename Signal>
     void leave(Signal &sig) {
-        Iterator it = m_connections.find(&sig);
-        if (it != m_connections.end()) {
-            leave(it);
-        }
+        leave(static_cast<TrackID>(&sig));
     }
 
 
     void leaveAll() {
         // disconnect all connections
         for ( ; !m_connections.empty(); ) {
-            leave(m_connections.begin());
+            leave(m_connections.back().first);
         }
     }
 
 protected:
 
     virtual void disconnect(SigImpl::SignalHolder& signal) {
-        m_connections.erase(&signal);
+        Iterator it = findConnection(&signal);
+        if (it != m_connections.end() && it->first == &signal)
+            m_connections.erase(it);
     }
 
 private:
-    typedef Connections::value_type ValueType;
     typedef Connections::iterator Iterator;
+
+    static bool lessSignal(const Connection &a, const SigImpl::SignalHolder *b) {
+        return a.first < b;
+    }
+
+    /// @return first connection that isn't sorted before @a sig
+    Iterator findConnection(const SigImpl::SignalHolder *sig) {
+        return std::lower_bound(m_connections.begin(), m_connections.end(),
+                                sig, lessSignal);
+    }
+
     /// holds all connections to different signals and slots.
     Connections m_connections;
 };
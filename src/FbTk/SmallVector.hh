@@ -0,0 +1,140 @@
+// SmallVector.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FBTK_SMALLVECTOR_HH
+#define FBTK_SMALLVECTOR_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+namespace FbTk {
+
+/**
+ * A vector that keeps up to N elements inside the object itself and only
+ * goes to the heap when it grows beyond that. Iterators are plain pointers
+ * and are invalidated by anything that adds or removes elements.
+ */
+template <typename T, size_t N>
+class SmallVector {
+public:
+    typedef T value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+
+    SmallVector(): m_data(inlineData()), m_size(0), m_capacity(N) { }
+
+    SmallVector(const SmallVector &other):
+        m_data(inlineData()), m_size(0), m_capacity(N) {
+        append(other);
+    }
+
+    ~SmallVector() {
+        clear();
+        if (m_data != inlineData())
+            ::operator delete(m_data);
+    }
+
+    SmallVector &operator = (const SmallVector &other) {
+        if (this != &other) {
+            clear();
+            append(other);
+        }
+        return *this;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+
+    T &operator [] (size_t i) { return m_data[i]; }
+    const T &operator [] (size_t i) const { return m_data[i]; }
+    T &back() { return m_data[m_size - 1]; }
+
+    void push_back(const T &value) {
+        if (m_size == m_capacity) {
+            // value might live in our own storage
+            T copy(value);
+            grow();
+            new (m_data + m_size) T(copy);
+        } else
+            new (m_data + m_size) T(value);
+        ++m_size;
+    }
+
+    iterator insert(iterator pos, const T &value) {
+        size_t index = pos - begin();
+        push_back(value);
+        std::rotate(begin() + index, end() - 1, end());
+        return begin() + index;
+    }
+
+    iterator erase(iterator first, iterator last) {
+        iterator new_end = std::copy(last, end(), first);
+        for (iterator it = new_end; it != end(); ++it)
+            it->~T();
+        m_size = new_end - begin();
+        return first;
+    }
+
+    iterator erase(iterator pos) { return erase(pos, pos + 1); }
+
+    void clear() { erase(begin(), end()); }
+
+private:
+    T *inlineData() { return reinterpret_cast<T *>(m_storage.buf); }
+
+    void append(const SmallVector &other) {
+        for (size_t i = 0; i < other.m_size; ++i)
+            push_back(other.m_data[i]);
+    }
+
+    void grow() {
+        size_t capacity = m_capacity * 2;
+        T *data = static_cast<T *>(::operator new(capacity * sizeof(T)));
+        for (size_t i = 0; i < m_size; ++i) {
+            new (data + i) T(m_data[i]);
+            m_data[i].~T();
+        }
+        if (m_data != inlineData())
+            ::operator delete(m_data);
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    T *m_data; ///< either the inline storage or a heap block
+    size_t m_size;
+    size_t m_capacity;
+    union {
+        char buf[N * sizeof(T)];
+        // only here for the alignment
+        void *align_pointer;
+        long double align_double;
+    } m_storage;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_SMALLVECTOR_HH
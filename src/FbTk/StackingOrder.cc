@@ -0,0 +1,110 @@
+// StackingOrder.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#include "StackingOrder.hh"
+
+#include <algorithm>
+#include <map>
+
+namespace FbTk {
+
+void StackingOrder::update(const std::vector<Window> &windows, Moves &moves) {
+    const size_t n = windows.size();
+
+    // where each wanted window is in the old order, -1 if it wasn't there
+    std::map<Window, int> old_pos;
+    for (size_t i = 0; i < m_windows.size(); ++i)
+        old_pos[m_windows[i]] = i;
+
+    std::vector<int> pos(n, -1);
+    for (size_t i = 0; i < n; ++i) {
+        std::map<Window, int>::const_iterator it = old_pos.find(windows[i]);
+        if (it != old_pos.end())
+            pos[i] = it->second;
+    }
+
+    // the longest subsequence already in order stays where it is,
+    // tails[k] is the last index of the best one of length k + 1
+    std::vector<int> tails, prev(n, -1);
+    for (size_t i = 0; i < n; ++i) {
+        if (pos[i] < 0)
+            continue;
+
+        size_t lo = 0, hi = tails.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (pos[tails[mid]] < pos[i])
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo > 0)
+            prev[i] = tails[lo - 1];
+        if (lo == tails.size())
+            tails.push_back(i);
+        else
+            tails[lo] = i;
+    }
+
+    std::vector<bool> keep(n, false);
+    if (!tails.empty()) {
+        for (int i = tails.back(); i >= 0; i = prev[i])
+            keep[i] = true;
+    } else if (n > 0) {
+        // nothing to go by, leave the top one where it is
+        keep[0] = true;
+    }
+
+    size_t first_kept = std::find(keep.begin(), keep.end(), true) - keep.begin();
+
+    for (size_t i = 0; i < n; ++i) {
+        if (keep[i])
+            continue;
+
+        Move move;
+        move.window = windows[i];
+        if (i == 0) {
+            move.sibling = windows[first_kept];
+            move.stack_mode = Above;
+        } else {
+            move.sibling = windows[i - 1];
+            move.stack_mode = Below;
+        }
+        moves.push_back(move);
+    }
+
+    m_windows = windows;
+}
+
+void StackingOrder::restack(Display *disp, const std::vector<Window> &windows) {
+    Moves moves;
+    update(windows, moves);
+
+    XWindowChanges changes;
+    for (Moves::const_iterator it = moves.begin(); it != moves.end(); ++it) {
+        changes.sibling = it->sibling;
+        changes.stack_mode = it->stack_mode;
+        XConfigureWindow(disp, it->window, CWSibling | CWStackMode, &changes);
+    }
+}
+
+} // end namespace FbTk
@@ -0,0 +1,75 @@
+// StackingOrder.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef FBTK_STACKINGORDER_HH
+#define FBTK_STACKINGORDER_HH
+
+#include <X11/Xlib.h>
+
+#include <vector>
+
+namespace FbTk {
+
+/// Remembers the stacking order last sent to the server
+/**
+   XRestackWindows sends one ConfigureWindow request for every window
+   after the first, even if only one of them moved.  This keeps the
+   order we sent last and moves just the windows that are out of place:
+   the ones that aren't part of the longest run of windows that already
+   are in the wanted order.  Raising a single window costs one request.
+
+   The order only includes windows we stacked ourselves, and it stays
+   right as long as nobody else restacks them relative to each other.
+*/
+class StackingOrder {
+public:
+    /// a window that has to be put directly above or below a sibling
+    struct Move {
+        Window window;
+        Window sibling;
+        int stack_mode; ///< Above or Below
+    };
+    typedef std::vector<Move> Moves;
+
+    /**
+       Computes the moves that turn the last order into @a windows
+       and remembers @a windows as the new order.
+       @param windows the wanted order, top to bottom
+       @param moves gets the moves appended, in the order they must be done
+    */
+    void update(const std::vector<Window> &windows, Moves &moves);
+
+    /// restacks the windows to @a windows with as few requests as possible
+    void restack(Display *disp, const std::vector<Window> &windows);
+
+    /// forgets the order, the next update moves all but one window
+    void clear() { m_windows.clear(); }
+
+    const std::vector<Window> &windows() const { return m_windows; }
+
+private:
+    std::vector<Window> m_windows;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_STACKINGORDER_HH
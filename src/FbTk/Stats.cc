@@ -1,5 +1,5 @@
-// SearchResult.cc for FbTk - Fluxbox Toolkit
-// Copyright (c) 2007 Fluxbox Team (fluxgen at fluxbox dot org)
+// Stats.cc for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
 //
 // Permission is hereby granted, free of charge, to any person obtaining a
 // copy of this software and associated documentation files (the "Software"),
@@ -19,33 +19,11 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 // DEALINGS IN THE SOFTWARE.
 
-#include "SearchResult.hh"
-#include "ITypeAheadable.hh"
+
+#include "Stats.hh"
 
 namespace FbTk {
 
-void SearchResult::seek() {
-    switch (m_results.size()) {
-    case 0:
-        break;
-    case 1:
-        m_seeked_string = m_results[0]->iTypeString();
-        break;
-    default:
-        bool seekforward = true;
-        for (size_t i=1; i < m_results.size() && seekforward &&
-            m_results[0]->iTypeCheckStringSize(m_seeked_string.size()); i++) {
-            if (!m_results[i]->iTypeCompareChar(
-                    m_results[0]->iTypeChar(m_seeked_string.size()),
-                    m_seeked_string.size())) {
-                seekforward = false;
-            } else if (i == m_results.size() - 1) {
-                m_seeked_string += m_results[0]->iTypeChar(m_seeked_string.size());
-                i = 0;
-            }
-        }
-        break;
-    }
-}
+bool Stats::s_enabled = false;
 
 } // end namespace FbTk
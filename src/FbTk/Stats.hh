@@ -0,0 +1,92 @@
+// Stats.hh for FbTk - Fluxbox ToolKit
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef FBTK_STATS_HH
+#define FBTK_STATS_HH
+
+#include <sys/time.h>
+
+namespace FbTk {
+
+/// Counts how often something happened and how long it took
+class TimeStat {
+public:
+    TimeStat(): m_count(0), m_total_usec(0), m_max_usec(0) { }
+
+    void add(long usec) {
+        ++m_count;
+        m_total_usec += usec;
+        if (usec > m_max_usec)
+            m_max_usec = usec;
+    }
+
+    unsigned long count() const { return m_count; }
+    long long totalUsec() const { return m_total_usec; }
+    long maxUsec() const { return m_max_usec; }
+
+private:
+    unsigned long m_count;
+    long long m_total_usec;
+    long m_max_usec;
+};
+
+/// Switch for the statistics that cost something to collect
+/**
+   Plain counters are always kept, they cost an increment.  Timing needs
+   a gettimeofday before and after, so it only happens after enable(),
+   which the dumpstats command and the stats query of the remote socket
+   do the first time they are used.
+*/
+class Stats {
+public:
+    static void enable() { s_enabled = true; }
+    static bool isEnabled() { return s_enabled; }
+
+private:
+    static bool s_enabled;
+};
+
+/// Adds the time until it is destroyed to a TimeStat, if Stats are enabled
+class StatTimer {
+public:
+    explicit StatTimer(TimeStat &stat): m_stat(Stats::isEnabled() ? &stat : 0) {
+        if (m_stat)
+            gettimeofday(&m_start, 0);
+    }
+
+    ~StatTimer() {
+        if (m_stat) {
+            timeval now;
+            gettimeofday(&now, 0);
+            m_stat->add((now.tv_sec - m_start.tv_sec) * 1000000L +
+                        (now.tv_usec - m_start.tv_usec));
+        }
+    }
+
+private:
+    TimeStat *m_stat;
+    timeval m_start;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_STATS_HH
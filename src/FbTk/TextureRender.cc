@@ -29,6 +29,7 @@
 #include "Texture.hh"
 #include "App.hh"
 #include "FbPixmap.hh"
+#include "ShmImage.hh"
 #include "GContext.hh"
 #include "I18n.hh"
 #include "StringUtil.hh"
@@ -47,6 +48,9 @@
 #else
   #include <string.h>
 #endif
+#ifdef HAVE_INTTYPES_H
+  #include <inttypes.h>
+#endif // HAVE_INTTYPES_H
 
 // mipspro has no new(nothrow)
 #if defined sgi && ! defined GCC
@@ -1531,9 +1535,51 @@ XImage *TextureRender::renderXImage() {
         return 0;
     }
 
-    image->data = 0;
-
     unsigned char *d = new unsigned char[image->bytes_per_line * (height + 1)];
+    image->data = (char *) d;
+
+    if (! renderXImage(image)) {
+        delete [] d;
+        image->data = 0;
+        XDestroyImage(image);
+        return 0;
+    }
+
+    return image;
+}
+
+bool TextureRender::renderXImage32(XImage *image) {
+    const int one = 1;
+    const int host_order = *(const char *)&one ? LSBFirst : MSBFirst;
+    if (image->bits_per_pixel != 32 || image->byte_order != host_order ||
+        red_bits != 1 || green_bits != 1 || blue_bits != 1)
+        return false;
+
+    // the color tables change nothing with 8 bits per channel, so a
+    // row is just shifts and ors that the compiler can vectorize
+    const unsigned int r_off = red_offset, g_off = green_offset,
+        b_off = blue_offset;
+    const unsigned char *r = red, *g = green, *b = blue;
+    for (unsigned int y = 0; y < height; y++) {
+        uint32_t *pixel = (uint32_t *) (image->data + y * image->bytes_per_line);
+        for (unsigned int x = 0; x < width; x++) {
+            pixel[x] = ((uint32_t) r[x] << r_off) |
+                       ((uint32_t) g[x] << g_off) |
+                       ((uint32_t) b[x] << b_off);
+        }
+        r += width;
+        g += width;
+        b += width;
+    }
+
+    return true;
+}
+
+bool TextureRender::renderXImage(XImage *image) {
+    if (control.visual()->c_class == TrueColor && renderXImage32(image))
+        return true;
+
+    unsigned char *d = (unsigned char *) image->data;
     register unsigned int x, y, r, g, b, o, offset;
 
     unsigned char *pixel_data = d, *ppixel_data = d;
@@ -1639,16 +1685,15 @@ XImage *TextureRender::renderXImage() {
         _FB_USES_NLS;
         cerr << "TextureRender::renderXImage(): " <<
             _FBTK_CONSOLETEXT(Error, UnsupportedVisual, "Unsupported visual", "A visual is a technical term in X") << endl;
-        delete [] d;
-        XDestroyImage(image);
-        return (XImage *) 0;
+        return false;
     }
 
-    image->data = (char *) d;
-    return image;
+    return true;
 }
 
 
+TimeStat TextureRender::s_upload_stat;
+
 Pixmap TextureRender::renderPixmap() {
     Display *disp = FbTk::App::instance()->display();
     FbPixmap pixmap(RootWindow(disp, control.screenNumber()),
@@ -1660,7 +1705,24 @@ Pixmap TextureRender::renderPixmap() {
         return None;
     }
 
-    XImage *image = renderXImage();
+    // straight into shared memory, if the server lets us
+    XImage *image = ShmImage::create(disp,
+                                     DefaultVisual(disp, control.screenNumber()),
+                                     control.depth(), width, height);
+    if (image) {
+        if (! renderXImage(image)) {
+            ShmImage::destroy(image);
+            return None;
+        }
+
+        StatTimer timer(s_upload_stat);
+        ShmImage::put(pixmap.drawable(),
+                      DefaultGC(disp, control.screenNumber()), image);
+        pixmap.rotate(orientation);
+        return pixmap.release();
+    }
+
+    image = renderXImage();
 
     if (! image) {
         return None;
@@ -1669,9 +1731,12 @@ Pixmap TextureRender::renderPixmap() {
         return None;
     }
 
-    XPutImage(disp, pixmap.drawable(),
-              DefaultGC(disp, control.screenNumber()),
-              image, 0, 0, 0, 0, width, height);
+    {
+        StatTimer timer(s_upload_stat);
+        XPutImage(disp, pixmap.drawable(),
+                  DefaultGC(disp, control.screenNumber()),
+                  image, 0, 0, 0, 0, width, height);
+    }
 
     if (image->data != 0) {
         delete [] image->data;
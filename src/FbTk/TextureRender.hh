@@ -26,6 +26,7 @@
 #define FBTK_TEXTURRENDER_HH
 
 #include "Orientation.hh"
+#include "Stats.hh"
 
 #include <X11/Xlib.h>
 
@@ -51,6 +52,9 @@ public:
     Pixmap renderGradient(const FbTk::Texture &src_texture);
     /// scales and renders a pixmap
     Pixmap renderPixmap(const FbTk::Texture &src_texture);
+
+    /// @return time spent sending rendered images to the server, see Stats
+    static const TimeStat &uploadStat() { return s_upload_stat; }
 private:
     /// allocates red, green and blue for gradient rendering
     void allocateColorTables();
@@ -64,6 +68,13 @@ private:
        @returns allocated and rendered XImage, user is responsible to deallocate
     */
     XImage *renderXImage();
+    /**
+       Render into the data of an XImage
+       @return false if the visual isn't supported
+    */
+    bool renderXImage(XImage *image);
+    /// fast path of renderXImage for 8 bit channels in native 32bpp
+    bool renderXImage32(XImage *image);
 
     ImageControl &control;
 
@@ -73,6 +84,8 @@ private:
     const unsigned char *red_table, *green_table, *blue_table;
     Orientation orientation;
     unsigned int width, height;
+
+    static TimeStat s_upload_stat;
 };
 
 } // end namespace FbTk 
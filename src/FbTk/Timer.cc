@@ -25,6 +25,7 @@
 #include "Timer.hh"
 
 #include "CommandParser.hh"
+#include "FdHandler.hh"
 #include "StringUtil.hh"
 
 //use GNU extensions
@@ -58,6 +59,7 @@
 namespace FbTk {
 
 Timer::TimerList Timer::m_timerlist;
+TimeStat Timer::s_timeout_stat;
 
 Timer::Timer():m_timing(false), m_once(false), m_interval(0) {
 
@@ -130,11 +132,13 @@ void Timer::fireTimeout() {
 }
 
 void Timer::updateTimers(int fd) {
-    fd_set rfds;
+    fd_set rfds, wfds;
     timeval now, tm, *timeout = 0;
 
     FD_ZERO(&rfds);
+    FD_ZERO(&wfds);
     FD_SET(fd, &rfds);
+    int maxfd = FdHandler::instance().fillSets(rfds, wfds, fd);
 
     bool overdue = false;
 
@@ -173,9 +177,22 @@ void Timer::updateTimers(int fd) {
     // if not overdue, wait for the next xevent via the blocking
     // select(), so OS sends fluxbox to sleep. the select() will
     // time out when the next timer has to be handled
-    if (!overdue && select(fd + 1, &rfds, 0, 0, timeout) != 0)
-        // didn't time out! x events are pending
-        return;
+    if (!overdue) {
+        int ready = select(maxfd + 1, &rfds, &wfds, 0, timeout);
+        if (ready > 0)
+            FdHandler::instance().dispatch(rfds, wfds);
+        if (ready != 0)
+            // didn't time out! x events or other descriptors are pending
+            return;
+    } else if (!FdHandler::instance().empty()) {
+        // zero timeout timers may stay overdue for a long time, don't
+        // let them starve the other descriptors. x events are left to
+        // the caller, they are checked before the next round anyway
+        timeval poll = { 0, 0 };
+        FD_CLR(fd, &rfds);
+        if (select(maxfd + 1, &rfds, &wfds, 0, &poll) > 0)
+            FdHandler::instance().dispatch(rfds, wfds);
+    }
 
     TimerList::iterator it;
 
@@ -209,21 +226,30 @@ void Timer::updateTimers(int fd) {
              (now.tv_sec == tm.tv_sec && now.tv_usec < tm.tv_usec)))
             break;
 
-        t.fireTimeout();
-        // restart the current timer so that the start time is updated
-        if (! t.doOnce()) {
-            // must erase so that it's put into the right place in the list
-            it = m_timerlist.erase(it);
+        if (t.doOnce()) {
+            // stop it before it fires, so that the handler
+            // may start it again
+            m_timerlist.erase(it);
             t.m_timing = false;
-            t.start();
-        } else {
-            // Since the default stop behaviour results in the timer
-            // being removed, we must remove it here, so that the iterator
-            // lives well. Another option would be to add it to another
-            // list, and then just go through that list and stop them all.
-            it = m_timerlist.erase(it);
-            t.stop();
+            {
+                StatTimer stat_timer(s_timeout_stat);
+                t.fireTimeout();
+            }
+            // the handler may have stopped or deleted any other timer,
+            // so start over instead of keeping an iterator into the list
+            it = m_timerlist.begin();
+            continue;
         }
+
+        {
+            StatTimer stat_timer(s_timeout_stat);
+            t.fireTimeout();
+        }
+        // restart the current timer so that the start time is updated
+        // must erase so that it's put into the right place in the list
+        it = m_timerlist.erase(it);
+        t.m_timing = false;
+        t.start();
     }
 
 }
@@ -27,6 +27,7 @@
 
 #include "RefCount.hh"
 #include "Command.hh"
+#include "Stats.hh"
 
 #ifdef HAVE_CTIME
   #include <ctime>
@@ -76,6 +77,10 @@ public:
     void stop();
     /// update all timers
     static void updateTimers(int file_descriptor);
+    /// @return number of running timers
+    static size_t numTimers() { return m_timerlist.size(); }
+    /// @return time spent in timeouts, see Stats
+    static const TimeStat &timeoutStat() { return s_timeout_stat; }
 
     int isTiming() const { return m_timing; }
     int getInterval() const { return m_interval; }
@@ -98,6 +103,7 @@ private:
 
     typedef std::list<Timer *> TimerList;
     static TimerList m_timerlist; ///< list of all timers, sorted by next trigger time (start + timeout)
+    static TimeStat s_timeout_stat;
 
     RefCount<Slot<void> > m_handler; ///< what to do on a timeout
 
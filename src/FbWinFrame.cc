@@ -30,6 +30,7 @@
 #include "FbTk/CompareEqual.hh"
 #include "FbTk/TextUtils.hh"
 #include "FbTk/STLUtil.hh"
+#include "FbTk/MemFun.hh"
 
 #include "FbWinFrameTheme.hh"
 #include "Screen.hh"
@@ -103,10 +104,14 @@ FbWinFrame::FbWinFrame(BScreen &screen, unsigned int client_depth,
     m_tabmode(screen.getDefaultInternalTabs()?INTERNAL:EXTERNAL),
     m_active_orig_client_bw(0),
     m_need_render(true),
+    m_render_damage(ELEM_ALL),
     m_button_size(1),
     m_focused_alpha(AlphaAcc(*theme.focusedTheme(), &FbWinFrameTheme::alpha)),
     m_unfocused_alpha(AlphaAcc(*theme.unfocusedTheme(), &FbWinFrameTheme::alpha)),
     m_shape(m_window, theme->shapePlace()) {
+    // the owner reconfigures us after a theme change, we only need
+    // to know that the old pixmaps are no good anymore
+    join(theme.reconfigSig(), FbTk::MemFun(*this, &FbWinFrame::themeReconfigured));
     init();
 }
 
@@ -127,6 +132,8 @@ bool FbWinFrame::setTabMode(TabMode tabmode) {
         tabmode = m_tabmode;
 
     m_tabmode = tabmode;
+    // the tab container texture depends on the mode, not just the size
+    m_render_damage |= ELEM_TABCONTAINER;
 
     // reparent tab container
     if (tabmode == EXTERNAL) {
@@ -475,18 +482,28 @@ void FbWinFrame::notifyMoved(bool clear) {
 }
 
 void FbWinFrame::clearAll() {
+    clearElements(ELEM_ALL);
+}
+
+void FbWinFrame::clearElements(unsigned int elements) {
 
     if  (m_use_titlebar) {
-        redrawTitlebar();
-        forAll(m_buttons_left, mem_fun(&FbTk::Button::clear));
-        forAll(m_buttons_right, mem_fun(&FbTk::Button::clear));
-    } else if (m_tabmode == EXTERNAL && m_use_tabs)
+        redrawTitlebar(elements);
+        if (elements & ELEM_BUTTONS) {
+            forAll(m_buttons_left, mem_fun(&FbTk::Button::clear));
+            forAll(m_buttons_right, mem_fun(&FbTk::Button::clear));
+        }
+    } else if (m_tabmode == EXTERNAL && m_use_tabs &&
+               (elements & ELEM_TABCONTAINER))
         m_tab_container.clear();
 
     if (m_use_handle) {
-        m_handle.clear();
-        m_grip_left.clear();
-        m_grip_right.clear();
+        if (elements & ELEM_HANDLE)
+            m_handle.clear();
+        if (elements & ELEM_GRIP) {
+            m_grip_left.clear();
+            m_grip_right.clear();
+        }
     }
 }
 
@@ -510,8 +527,14 @@ void FbWinFrame::setFocus(bool newvalue) {
 
     setBorderWidth();
 
-    applyAll();
-    clearAll();
+    // with the same alpha for both, only touch the parts that look
+    // different, two frames change focus at once after all
+    unsigned int elements = ELEM_ALL;
+    if (getAlpha(true) == getAlpha(false))
+        elements = focusDamage();
+
+    applyAll(elements);
+    clearElements(elements);
 }
 
 void FbWinFrame::applyState() {
@@ -1020,14 +1043,17 @@ unsigned int FbWinFrame::buttonHeight() const {
 /**
    aligns and redraws title
 */
-void FbWinFrame::redrawTitlebar() {
+void FbWinFrame::redrawTitlebar(unsigned int elements) {
     if (!m_use_titlebar || m_tab_container.empty())
         return;
 
     if (isVisible()) {
-        m_tab_container.clear();
-        m_label.clear();
-        m_titlebar.clear();
+        if (elements & ELEM_TABCONTAINER)
+            m_tab_container.clear();
+        if (elements & ELEM_LABEL)
+            m_label.clear();
+        if (elements & ELEM_TITLE)
+            m_titlebar.clear();
     }
 }
 
@@ -1114,10 +1140,61 @@ void FbWinFrame::renderAll() {
     renderTabContainer();
 }
 
-void FbWinFrame::applyAll() {
-    applyTitlebar();
-    applyHandles();
-    applyTabContainer();
+void FbWinFrame::applyAll(unsigned int elements) {
+    if (elements & (ELEM_TITLE | ELEM_LABEL | ELEM_BUTTONS))
+        applyTitlebar(elements);
+    if (elements & (ELEM_HANDLE | ELEM_GRIP))
+        applyHandles(elements);
+    if (elements & ELEM_TABCONTAINER)
+        applyTabContainer();
+}
+
+bool FbWinFrame::needsRender(Element element, RenderedSize &rendered,
+                             unsigned int width, unsigned int height,
+                             FbTk::Orientation orient) {
+    if (!(m_render_damage & element) && rendered.width == width &&
+        rendered.height == height && rendered.orient == orient)
+        return false;
+
+    m_render_damage &= ~element;
+    rendered.width = width;
+    rendered.height = height;
+    rendered.orient = orient;
+    return true;
+}
+
+namespace {
+
+bool looksDifferent(Pixmap pm1, const FbTk::Color &color1,
+                    Pixmap pm2, const FbTk::Color &color2) {
+    // the image cache hands out the same pixmap for the same texture
+    if (pm1 != None || pm2 != None)
+        return pm1 != pm2;
+    return color1.pixel() != color2.pixel();
+}
+
+} // end anonymous namespace
+
+unsigned int FbWinFrame::focusDamage() const {
+    // the label text, tabs and button pictures follow the focus on
+    // their own, so they are always redrawn
+    unsigned int elements = ELEM_LABEL | ELEM_TABCONTAINER | ELEM_BUTTONS;
+
+    if (looksDifferent(m_title_focused_pm, m_title_focused_color,
+                       m_title_unfocused_pm, m_title_unfocused_color))
+        elements |= ELEM_TITLE;
+    if (looksDifferent(m_handle_focused_pm, m_handle_focused_color,
+                       m_handle_unfocused_pm, m_handle_unfocused_color))
+        elements |= ELEM_HANDLE;
+    if (looksDifferent(m_grip_focused_pm, m_grip_focused_color,
+                       m_grip_unfocused_pm, m_grip_unfocused_color))
+        elements |= ELEM_GRIP;
+
+    return elements;
+}
+
+void FbWinFrame::themeReconfigured() {
+    m_render_damage = ELEM_ALL;
 }
 
 void FbWinFrame::renderTitlebar() {
@@ -1130,23 +1207,29 @@ void FbWinFrame::renderTitlebar() {
     }
 
     // render pixmaps
-    render(theme().focusedTheme()->titleTexture(), m_title_focused_color,
-           m_title_focused_pm,
-           m_titlebar.width(), m_titlebar.height());
-
-    render(theme().unfocusedTheme()->titleTexture(), m_title_unfocused_color,
-           m_title_unfocused_pm,
-           m_titlebar.width(), m_titlebar.height());
+    if (needsRender(ELEM_TITLE, m_title_rendered,
+                    m_titlebar.width(), m_titlebar.height())) {
+        render(theme().focusedTheme()->titleTexture(), m_title_focused_color,
+               m_title_focused_pm,
+               m_titlebar.width(), m_titlebar.height());
+
+        render(theme().unfocusedTheme()->titleTexture(), m_title_unfocused_color,
+               m_title_unfocused_pm,
+               m_titlebar.width(), m_titlebar.height());
+    }
 
     //!! TODO: don't render label if internal tabs
 
-    render(theme().focusedTheme()->iconbarTheme()->texture(),
-           m_label_focused_color, m_label_focused_pm,
-           m_label.width(), m_label.height());
+    if (needsRender(ELEM_LABEL, m_label_rendered,
+                    m_label.width(), m_label.height())) {
+        render(theme().focusedTheme()->iconbarTheme()->texture(),
+               m_label_focused_color, m_label_focused_pm,
+               m_label.width(), m_label.height());
 
-    render(theme().unfocusedTheme()->iconbarTheme()->texture(),
-           m_label_unfocused_color, m_label_unfocused_pm,
-           m_label.width(), m_label.height());
+        render(theme().unfocusedTheme()->iconbarTheme()->texture(),
+               m_label_unfocused_color, m_label_unfocused_pm,
+               m_label.width(), m_label.height());
+    }
 
 }
 
@@ -1164,19 +1247,23 @@ void FbWinFrame::renderTabContainer() {
     if (m_tabmode == EXTERNAL && tc_unfocused->type() & FbTk::Texture::PARENTRELATIVE)
         tc_unfocused = &theme().unfocusedTheme()->titleTexture();
 
-    render(*tc_focused, m_tabcontainer_focused_color,
-           m_tabcontainer_focused_pm,
-           m_tab_container.width(), m_tab_container.height(), m_tab_container.orientation());
+    if (needsRender(ELEM_TABCONTAINER, m_tabcontainer_rendered,
+                    m_tab_container.width(), m_tab_container.height(),
+                    m_tab_container.orientation())) {
+        render(*tc_focused, m_tabcontainer_focused_color,
+               m_tabcontainer_focused_pm,
+               m_tab_container.width(), m_tab_container.height(), m_tab_container.orientation());
 
-    render(*tc_unfocused, m_tabcontainer_unfocused_color,
-           m_tabcontainer_unfocused_pm,
-           m_tab_container.width(), m_tab_container.height(), m_tab_container.orientation());
+        render(*tc_unfocused, m_tabcontainer_unfocused_color,
+               m_tabcontainer_unfocused_pm,
+               m_tab_container.width(), m_tab_container.height(), m_tab_container.orientation());
+    }
 
     renderButtons();
 
 }
 
-void FbWinFrame::applyTitlebar() {
+void FbWinFrame::applyTitlebar(unsigned int elements) {
 
     // set up pixmaps for titlebar windows
     Pixmap label_pm = None;
@@ -1190,7 +1277,7 @@ void FbWinFrame::applyTitlebar() {
     m_titlebar.setAlpha(alpha);
     m_label.setAlpha(alpha);
 
-    if (m_tabmode != INTERNAL) {
+    if (m_tabmode != INTERNAL && (elements & ELEM_LABEL)) {
         m_label.setGC(theme()->iconbarTheme()->text().textGC());
         m_label.setJustify(theme()->iconbarTheme()->text().justify());
 
@@ -1200,12 +1287,15 @@ void FbWinFrame::applyTitlebar() {
             m_label.setBackgroundColor(label_color);
     }
 
-    if (title_pm != 0)
-        m_titlebar.setBackgroundPixmap(title_pm);
-    else
-        m_titlebar.setBackgroundColor(title_color);
+    if (elements & ELEM_TITLE) {
+        if (title_pm != 0)
+            m_titlebar.setBackgroundPixmap(title_pm);
+        else
+            m_titlebar.setBackgroundColor(title_color);
+    }
 
-    applyButtons();
+    if (elements & ELEM_BUTTONS)
+        applyButtons();
 }
 
 
@@ -1218,61 +1308,59 @@ void FbWinFrame::renderHandles() {
         return;
     }
 
-    render(theme().focusedTheme()->handleTexture(), m_handle_focused_color,
-           m_handle_focused_pm,
-           m_handle.width(), m_handle.height());
+    if (needsRender(ELEM_HANDLE, m_handle_rendered,
+                    m_handle.width(), m_handle.height())) {
+        render(theme().focusedTheme()->handleTexture(), m_handle_focused_color,
+               m_handle_focused_pm,
+               m_handle.width(), m_handle.height());
 
-    render(theme().unfocusedTheme()->handleTexture(), m_handle_unfocused_color,
-           m_handle_unfocused_pm,
-           m_handle.width(), m_handle.height());
+        render(theme().unfocusedTheme()->handleTexture(), m_handle_unfocused_color,
+               m_handle_unfocused_pm,
+               m_handle.width(), m_handle.height());
+    }
 
-    render(theme().focusedTheme()->gripTexture(), m_grip_focused_color,
-           m_grip_focused_pm,
-           m_grip_left.width(), m_grip_left.height());
+    if (needsRender(ELEM_GRIP, m_grip_rendered,
+                    m_grip_left.width(), m_grip_left.height())) {
+        render(theme().focusedTheme()->gripTexture(), m_grip_focused_color,
+               m_grip_focused_pm,
+               m_grip_left.width(), m_grip_left.height());
 
-    render(theme().unfocusedTheme()->gripTexture(), m_grip_unfocused_color,
-           m_grip_unfocused_pm,
-           m_grip_left.width(), m_grip_left.height());
+        render(theme().unfocusedTheme()->gripTexture(), m_grip_unfocused_color,
+               m_grip_unfocused_pm,
+               m_grip_left.width(), m_grip_left.height());
+    }
 
 }
 
-void FbWinFrame::applyHandles() {
+void FbWinFrame::applyHandles(unsigned int elements) {
 
     int alpha = getAlpha(m_state.focused);
     m_handle.setAlpha(alpha);
     m_grip_left.setAlpha(alpha);
     m_grip_right.setAlpha(alpha);
 
-    if (m_state.focused) {
+    Pixmap handle_pm = m_state.focused ? m_handle_focused_pm : m_handle_unfocused_pm;
+    const FbTk::Color &handle_color = m_state.focused ? m_handle_focused_color
+                                                      : m_handle_unfocused_color;
+    Pixmap grip_pm = m_state.focused ? m_grip_focused_pm : m_grip_unfocused_pm;
+    const FbTk::Color &grip_color = m_state.focused ? m_grip_focused_color
+                                                    : m_grip_unfocused_color;
 
-        if (m_handle_focused_pm) {
-            m_handle.setBackgroundPixmap(m_handle_focused_pm);
+    if (elements & ELEM_HANDLE) {
+        if (handle_pm) {
+            m_handle.setBackgroundPixmap(handle_pm);
         } else {
-            m_handle.setBackgroundColor(m_handle_focused_color);
-        }
-
-        if (m_grip_focused_pm) {
-            m_grip_left.setBackgroundPixmap(m_grip_focused_pm);
-            m_grip_right.setBackgroundPixmap(m_grip_focused_pm);
-        } else {
-            m_grip_left.setBackgroundColor(m_grip_focused_color);
-            m_grip_right.setBackgroundColor(m_grip_focused_color);
-        }
-
-    } else {
-
-        if (m_handle_unfocused_pm) {
-            m_handle.setBackgroundPixmap(m_handle_unfocused_pm);
-        } else {
-            m_handle.setBackgroundColor(m_handle_unfocused_color);
+            m_handle.setBackgroundColor(handle_color);
         }
+    }
 
-        if (m_grip_unfocused_pm) {
-            m_grip_left.setBackgroundPixmap(m_grip_unfocused_pm);
-            m_grip_right.setBackgroundPixmap(m_grip_unfocused_pm);
+    if (elements & ELEM_GRIP) {
+        if (grip_pm) {
+            m_grip_left.setBackgroundPixmap(grip_pm);
+            m_grip_right.setBackgroundPixmap(grip_pm);
         } else {
-            m_grip_left.setBackgroundColor(m_grip_unfocused_color);
-            m_grip_right.setBackgroundColor(m_grip_unfocused_color);
+            m_grip_left.setBackgroundColor(grip_color);
+            m_grip_right.setBackgroundColor(grip_color);
         }
     }
 
@@ -1285,6 +1373,10 @@ void FbWinFrame::renderButtons() {
         return;
     }
 
+    if (!needsRender(ELEM_BUTTONS, m_button_rendered,
+                     m_button_size, m_button_size))
+        return;
+
     render(theme().focusedTheme()->buttonTexture(), m_button_color,
            m_button_pm,
            m_button_size, m_button_size);
@@ -52,7 +52,7 @@ class Texture;
 
 /// holds a window frame with a client window
 /// (see: <a href="fluxbox_fbwinframe.png">image</a>)
-class FbWinFrame:public FbTk::EventHandler {
+class FbWinFrame:public FbTk::EventHandler, private FbTk::SignalTracker {
 public:
     // STRICTINTERNAL means it doesn't go external automatically when no titlebar
     enum TabMode { NOTSET = 0, INTERNAL = 1, EXTERNAL };
@@ -239,7 +239,35 @@ public:
     //@}
 
 private:
-    void redrawTitlebar();
+    /// decoration elements, to track which of them need work
+    enum Element {
+        ELEM_TITLE = 1 << 0,
+        ELEM_LABEL = 1 << 1,
+        ELEM_TABCONTAINER = 1 << 2,
+        ELEM_HANDLE = 1 << 3,
+        ELEM_GRIP = 1 << 4,
+        ELEM_BUTTONS = 1 << 5,
+        ELEM_ALL = (1 << 6) - 1
+    };
+
+    /// what the pixmaps of an element were last rendered for
+    struct RenderedSize {
+        RenderedSize(): width(0), height(0), orient(FbTk::ROT0) { }
+        unsigned int width, height;
+        FbTk::Orientation orient;
+    };
+
+    /// @return true if @a element has to be rendered again for this size
+    bool needsRender(Element element, RenderedSize &rendered,
+                     unsigned int width, unsigned int height,
+                     FbTk::Orientation orient = FbTk::ROT0);
+    /// @return elements that look different when focused
+    unsigned int focusDamage() const;
+    void themeReconfigured();
+
+    void redrawTitlebar(unsigned int elements = ELEM_ALL);
+    /// clears @a elements so they are drawn with their new backgrounds
+    void clearElements(unsigned int elements);
 
     /// reposition titlebar items
     void reconfigureTitlebar();
@@ -276,9 +304,9 @@ private:
        @name apply pixmaps depending on focus
     */
     //@{
-    void applyAll();
-    void applyTitlebar();
-    void applyHandles();
+    void applyAll(unsigned int elements = ELEM_ALL);
+    void applyTitlebar(unsigned int elements = ELEM_ALL);
+    void applyHandles(unsigned int elements = ELEM_ALL);
     void applyTabContainer(); // and label buttons
     void applyButtons(); // only called within applyTitlebar
 
@@ -371,6 +399,10 @@ private:
     unsigned int m_active_orig_client_bw;
 
     bool m_need_render;
+    /// elements that must be rendered even if their size didn't change
+    unsigned int m_render_damage;
+    RenderedSize m_title_rendered, m_label_rendered, m_tabcontainer_rendered,
+        m_handle_rendered, m_grip_rendered, m_button_rendered;
     int m_button_size; ///< size for all titlebar buttons
     /// alpha values
     typedef FbTk::ConstObjectAccessor<int, FbWinFrameTheme> AlphaAcc;
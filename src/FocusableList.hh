@@ -29,6 +29,7 @@
 #include "ClientPattern.hh"
 
 #include <list>
+#include <map>
 #include <string>
 #include <memory>
 
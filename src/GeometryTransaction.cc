@@ -0,0 +1,95 @@
+// GeometryTransaction.cc for Fluxbox Window Manager
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "GeometryTransaction.hh"
+
+#include "Screen.hh"
+#include "Window.hh"
+#include "fluxbox.hh"
+
+#include "FbTk/App.hh"
+#include "FbTk/MultLayers.hh"
+
+GeometryTransaction::Lock::Lock(BScreen &screen): m_screen(screen) {
+    Fluxbox::instance()->grab();
+    m_screen.layerManager().lock();
+}
+
+GeometryTransaction::Lock::~Lock() {
+    m_screen.layerManager().unlock();
+    Fluxbox::instance()->ungrab();
+    XFlush(FbTk::App::instance()->display());
+}
+
+void GeometryTransaction::move(FluxboxWindow &win, int x, int y) {
+    Change change = { &win, MOVE, x, y, 0, 0 };
+    add(change);
+}
+
+void GeometryTransaction::moveResize(FluxboxWindow &win, int x, int y,
+                                     unsigned int width, unsigned int height) {
+    Change change = { &win, MOVE_RESIZE, x, y, width, height };
+    add(change);
+}
+
+void GeometryTransaction::iconify(FluxboxWindow &win) {
+    Change change = { &win, ICONIFY, 0, 0, 0, 0 };
+    add(change);
+}
+
+void GeometryTransaction::add(const Change &change) {
+    std::vector<Change>::iterator it = m_changes.begin();
+    for (; it != m_changes.end(); ++it) {
+        if (it->win == change.win) {
+            *it = change;
+            return;
+        }
+    }
+    m_changes.push_back(change);
+}
+
+void GeometryTransaction::commit() {
+    if (m_changes.empty())
+        return;
+
+    Lock lock(m_screen);
+
+    std::vector<Change>::iterator it = m_changes.begin();
+    for (; it != m_changes.end(); ++it) {
+        FluxboxWindow &win = *it->win;
+        switch (it->type) {
+        case MOVE:
+            if (win.x() != it->x || win.y() != it->y)
+                win.move(it->x, it->y);
+            break;
+        case MOVE_RESIZE:
+            if (win.x() != it->x || win.y() != it->y ||
+                win.width() != it->width || win.height() != it->height)
+                win.moveResize(it->x, it->y, it->width, it->height);
+            break;
+        case ICONIFY:
+            win.iconify();
+            break;
+        }
+    }
+
+    m_changes.clear();
+}
@@ -0,0 +1,78 @@
+// GeometryTransaction.hh for Fluxbox Window Manager
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef GEOMETRYTRANSACTION_HH
+#define GEOMETRYTRANSACTION_HH
+
+#include "FbTk/NotCopyable.hh"
+
+#include <vector>
+
+class BScreen;
+class FluxboxWindow;
+
+/// Changes many windows of a screen as one update
+/**
+   Collects new geometries (and iconifications) and applies them all in
+   commit().  While it does, the server is grabbed, so neither clients
+   nor the compositor show any of the in between layouts, and the layers
+   are locked, so the windows get restacked once at the end.  A window
+   that is changed several times only gets its last change, and windows
+   that already are where they should be aren't touched.
+*/
+class GeometryTransaction: private FbTk::NotCopyable {
+public:
+    /// Holds back updates on a screen for as long as it exists
+    class Lock: private FbTk::NotCopyable {
+    public:
+        explicit Lock(BScreen &screen);
+        ~Lock();
+    private:
+        BScreen &m_screen;
+    };
+
+    explicit GeometryTransaction(BScreen &screen): m_screen(screen) { }
+    /// commits what is left
+    ~GeometryTransaction() { commit(); }
+
+    void move(FluxboxWindow &win, int x, int y);
+    void moveResize(FluxboxWindow &win, int x, int y,
+                    unsigned int width, unsigned int height);
+    void iconify(FluxboxWindow &win);
+
+    /// applies all collected changes
+    void commit();
+
+private:
+    enum Type { MOVE, MOVE_RESIZE, ICONIFY };
+    struct Change {
+        FluxboxWindow *win;
+        Type type;
+        int x, y;
+        unsigned int width, height;
+    };
+    void add(const Change &change);
+
+    BScreen &m_screen;
+    std::vector<Change> m_changes;
+};
+
+#endif // GEOMETRYTRANSACTION_HH
@@ -53,7 +53,13 @@ IconButton::IconButton(const FbTk::FbWindow &parent,
     m_use_pixmap(true),
     m_has_tooltip(false),
     m_theme(win, focused_theme, unfocused_theme),
-    m_pm(win.screen().imageControl()) {
+    m_focused_pm(win.screen().imageControl()),
+    m_unfocused_pm(win.screen().imageControl()),
+    m_focused_pm_valid(false),
+    m_unfocused_pm_valid(false),
+    m_pm_width(0),
+    m_pm_height(0),
+    m_pm_orient(FbTk::ROT0) {
 
     m_signals.join(m_win.titleSig(),
                    MemFunIgnoreArgs(*this, &IconButton::clientTitleChanged));
@@ -64,6 +70,13 @@ IconButton::IconButton(const FbTk::FbWindow &parent,
     m_signals.join(m_win.attentionSig(),
                    MemFunIgnoreArgs(*this, &IconButton::reconfigAndClear));
 
+    m_signals.join(m_theme.focusedTheme().reconfigSig(),
+                   FbTk::MemFun(*this, &IconButton::themeChanged));
+    m_signals.join(m_theme.unfocusedTheme().reconfigSig(),
+                   FbTk::MemFun(*this, &IconButton::themeChanged));
+
+    m_idle_render.setFunctor(FbTk::MemFun(*this, &IconButton::renderIdlePixmap));
+
     FbTk::EventManager::instance()->add(*this, m_icon_window);
 
     reconfigTheme();
@@ -144,19 +157,54 @@ void IconButton::setPixmap(bool use) {
     }
 }
 
+Pixmap IconButton::backgroundPixmap(bool focused) {
+    FbTk::CachedPixmap &pm = focused ? m_focused_pm : m_unfocused_pm;
+    bool &valid = focused ? m_focused_pm_valid : m_unfocused_pm_valid;
+    if (valid)
+        return pm;
+
+    const FbTk::Texture &texture = focused ?
+        m_theme.focusedTheme()->texture() : m_theme.unfocusedTheme()->texture();
+    if (texture.usePixmap())
+        pm.reset(m_win.screen().imageControl().renderImage(
+                         width(), height(), texture, orientation()));
+    else
+        pm.reset(0);
+
+    valid = true;
+    return pm;
+}
+
+void IconButton::renderIdlePixmap() {
+    backgroundPixmap(!useFocusedTheme());
+}
+
+void IconButton::themeChanged() {
+    m_focused_pm_valid = m_unfocused_pm_valid = false;
+    reconfigAndClear();
+}
+
 void IconButton::reconfigTheme() {
 
-    if (m_theme->texture().usePixmap())
-        m_pm.reset(m_win.screen().imageControl().renderImage(
-                           width(), height(), m_theme->texture(),
-                           orientation()));
-    else
-        m_pm.reset(0);
+    if (m_pm_width != width() || m_pm_height != height() ||
+        m_pm_orient != orientation()) {
+        m_pm_width = width();
+        m_pm_height = height();
+        m_pm_orient = orientation();
+        m_focused_pm_valid = m_unfocused_pm_valid = false;
+    }
+
+    bool focused = useFocusedTheme();
+    Pixmap pm = backgroundPixmap(focused);
+    // have the other one ready for the next focus change, but
+    // don't hold up whatever made us reconfigure
+    if (!(focused ? m_unfocused_pm_valid : m_focused_pm_valid))
+        m_idle_render.schedule();
 
     setAlpha(parent()->alpha());
 
-    if (m_pm != 0)
-        setBackgroundPixmap(m_pm);
+    if (pm != 0)
+        setBackgroundPixmap(pm);
     else
         setBackgroundColor(m_theme->texture().color());
 
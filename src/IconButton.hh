@@ -29,6 +29,7 @@
 #include "FbTk/FbPixmap.hh"
 #include "FbTk/TextButton.hh"
 #include "FbTk/Signal.hh"
+#include "FbTk/RenderQueue.hh"
 
 class IconbarTheme;
 
@@ -68,6 +69,15 @@ protected:
     void drawText(int x, int y, FbTk::FbDrawable *drawable_override);
 private:
     void reconfigAndClear();
+    /// @return true if the focused theme applies
+    bool useFocusedTheme() const {
+        return m_win.isFocused() || m_win.getAttentionState();
+    }
+    /// @return background for a focus state, renders it if needed
+    Pixmap backgroundPixmap(bool focused);
+    /// renders the background of the focus state that isn't shown
+    void renderIdlePixmap();
+    void themeChanged();
     void setupWindow();
     void showTooltip();
 
@@ -86,8 +96,13 @@ private:
     /// i.e if it got enter notify
     bool m_has_tooltip;
     FocusableTheme<IconbarTheme> m_theme;
-    // cached pixmaps
-    FbTk::CachedPixmap m_pm;
+    // cached backgrounds for both focus states, at the current size,
+    // so a focus change just swaps them
+    FbTk::CachedPixmap m_focused_pm, m_unfocused_pm;
+    bool m_focused_pm_valid, m_unfocused_pm_valid;
+    unsigned int m_pm_width, m_pm_height;
+    FbTk::Orientation m_pm_orient;
+    FbTk::RenderQueue::Job m_idle_render;
     FbTk::SignalTracker m_signals;
 };
 
@@ -426,14 +426,29 @@ void IconbarTool::update(UpdateReason reason, Focusable *win) {
     m_icon_container.update();
     m_icon_container.showSubwindows();
 
-    // another renderTheme we hopefully shouldn't need? These renders
-    // should be done individually above
+    if (reason == LIST_RESET || reason == ALIGN) {
+        renderTheme();
+        return;
+    }
 
-    // nope, we still need it (or at least I'm not bothering to fix it yet)
-    // a new IconButton doesn't get resized properly until the
-    // m_icon_container.update() above; then, it never runs drawText() again,
-    // so text can end up behind program icons
-    renderTheme();
+    // a new IconButton doesn't get its final size until the
+    // m_icon_container.update() above, so it and every button the
+    // layout moved or resized need to be drawn again, but only those
+    IconButton *added = 0;
+    if (reason != LIST_REMOVE) {
+        IconMap::iterator icon_it = m_icons.find(win);
+        if (icon_it != m_icons.end())
+            added = icon_it->second;
+    }
+
+    const FbTk::Container::ItemList &items = m_icon_container.repositionedItems();
+    FbTk::Container::ItemList::const_iterator it = items.begin();
+    for (; it != items.end(); ++it) {
+        if (*it != added)
+            renderButton(*static_cast<IconButton *>(*it));
+    }
+    if (added)
+        renderButton(*added);
 }
 
 void IconbarTool::insertWindow(Focusable &win, int pos) {
@@ -42,6 +42,7 @@
 #include "FbTk/AutoReloadHelper.hh"
 #include "FbTk/RefCount.hh"
 #include "FbTk/Util.hh"
+#include "FbTk/MemFun.hh"
 
 #ifdef HAVE_CSTRING
   #include <cstring>
@@ -642,7 +643,8 @@ Remember *Remember::s_instance = 0;
 
 Remember::Remember():
     m_pats(new Patterns()),
-    m_reloader(new FbTk::AutoReloadHelper()) {
+    m_reloader(new FbTk::AutoReloadHelper()),
+    m_checked(false) {
 
     setName("remember");
 
@@ -653,11 +655,22 @@ Remember::Remember():
     enableUpdate();
 
     m_reloader->setReloadCmd(FbTk::RefCount<FbTk::Command<void> >(new FbTk::SimpleCommand<Remember>(*this, &Remember::reload)));
+
+    // both fire as soon as the pending events are handled
+    m_check_timer.setTimeout(0, 0);
+    m_check_timer.fireOnce(true);
+    m_check_timer.setFunctor(FbTk::MemFun(*this, &Remember::expireCheck));
+    m_save_timer.setTimeout(0, 0);
+    m_save_timer.fireOnce(true);
+    m_save_timer.setFunctor(FbTk::MemFun(*this, &Remember::writeApps));
+
     reconfigure();
 }
 
 Remember::~Remember() {
 
+    flushSave();
+
     // free our resources
 
     // the patterns free the "Application"s
@@ -728,7 +741,15 @@ void Remember::reconfigure() {
 }
 
 void Remember::checkReload() {
+    // a burst of new windows only needs to look at the file once
+    if (m_checked)
+        return;
+
+    // our own changes must not be dropped by a reload
+    flushSave();
     m_reloader->checkReload();
+    m_checked = true;
+    m_check_timer.start();
 }
 
 void Remember::reload() {
@@ -877,6 +898,18 @@ void Remember::reload() {
 }
 
 void Remember::save() {
+    // several changes in a row end up in a single write
+    m_save_timer.start();
+}
+
+void Remember::flushSave() {
+    if (!m_save_timer.isTiming())
+        return;
+    m_save_timer.stop();
+    writeApps();
+}
+
+void Remember::writeApps() {
 
     string apps_string = FbTk::StringUtil::expandFilename(Fluxbox::instance()->getAppsFilename());
 
@@ -888,7 +921,7 @@ void Remember::save() {
     Startups::iterator sit = m_startups.begin();
     Startups::iterator sit_end = m_startups.end();
     for (; sit != sit_end; ++sit) {
-        apps_file<<"[startup] "<<(*sit)<<endl;
+        apps_file<<"[startup] "<<(*sit)<<'\n';
     }
 
     Patterns::iterator it = m_pats->begin();
@@ -907,31 +940,31 @@ void Remember::save() {
             apps_file << "[group]";
             if (a.group_pattern)
                 apps_file << " " << a.group_pattern->toString();
-            apps_file << endl;
+            apps_file << '\n';
 
             Patterns::iterator git = m_pats->begin();
             Patterns::iterator git_end = m_pats->end();
             for (; git != git_end; ++git) {
                 if (git->second == &a) {
                     apps_file << (a.is_transient ? " [transient]" : " [app]") <<
-                                 git->first->toString()<<endl;
+                                 git->first->toString()<<'\n';
                 }
             }
         } else {
             apps_file << (a.is_transient ? "[transient]" : "[app]") <<
-                         it->first->toString()<<endl;
+                         it->first->toString()<<'\n';
         }
         if (a.workspace_remember) {
-            apps_file << "  [Workspace]\t{" << a.workspace << "}" << endl;
+            apps_file << "  [Workspace]\t{" << a.workspace << "}" << '\n';
         }
         if (a.head_remember) {
-            apps_file << "  [Head]\t{" << a.head << "}" << endl;
+            apps_file << "  [Head]\t{" << a.head << "}" << '\n';
         }
         if (a.dimensions_remember) {
             if(a.dimension_is_relative) {
-              apps_file << "  [Dimensions]\t{" << a.w << "% " << a.h << "%}" << endl;
+              apps_file << "  [Dimensions]\t{" << a.w << "% " << a.h << "%}" << '\n';
             } else {
-              apps_file << "  [Dimensions]\t{" << a.w << " " << a.h << "}" << endl;
+              apps_file << "  [Dimensions]\t{" << a.w << " " << a.h << "}" << '\n';
             }
         }
         if (a.position_remember) {
@@ -965,40 +998,40 @@ void Remember::save() {
                 apps_file << "UPPERLEFT";
             }
             if(a.position_is_relative) {
-              apps_file << ")\t{" << a.x << "% " << a.y << "%}" << endl;
+              apps_file << ")\t{" << a.x << "% " << a.y << "%}" << '\n';
             } else {
-              apps_file << ")\t{" << a.x << " " << a.y << "}" << endl;
+              apps_file << ")\t{" << a.x << " " << a.y << "}" << '\n';
             }
         }
         if (a.shadedstate_remember) {
-            apps_file << "  [Shaded]\t{" << ((a.shadedstate)?"yes":"no") << "}" << endl;
+            apps_file << "  [Shaded]\t{" << ((a.shadedstate)?"yes":"no") << "}" << '\n';
         }
         if (a.tabstate_remember) {
-            apps_file << "  [Tab]\t\t{" << ((a.tabstate)?"yes":"no") << "}" << endl;
+            apps_file << "  [Tab]\t\t{" << ((a.tabstate)?"yes":"no") << "}" << '\n';
         }
         if (a.decostate_remember) {
             switch (a.decostate) {
             case (0) :
-                apps_file << "  [Deco]\t{NONE}" << endl;
+                apps_file << "  [Deco]\t{NONE}" << '\n';
                 break;
             case (0xffffffff):
             case (WindowState::DECOR_NORMAL):
-                apps_file << "  [Deco]\t{NORMAL}" << endl;
+                apps_file << "  [Deco]\t{NORMAL}" << '\n';
                 break;
             case (WindowState::DECOR_TOOL):
-                apps_file << "  [Deco]\t{TOOL}" << endl;
+                apps_file << "  [Deco]\t{TOOL}" << '\n';
                 break;
             case (WindowState::DECOR_TINY):
-                apps_file << "  [Deco]\t{TINY}" << endl;
+                apps_file << "  [Deco]\t{TINY}" << '\n';
                 break;
             case (WindowState::DECOR_BORDER):
-                apps_file << "  [Deco]\t{BORDER}" << endl;
+                apps_file << "  [Deco]\t{BORDER}" << '\n';
                 break;
             case (WindowState::DECORM_TAB):
-                apps_file << "  [Deco]\t{TAB}" << endl;
+                apps_file << "  [Deco]\t{TAB}" << '\n';
                 break;
             default:
-                apps_file << "  [Deco]\t{0x"<<hex<<a.decostate<<dec<<"}"<<endl;
+                apps_file << "  [Deco]\t{0x"<<hex<<a.decostate<<dec<<"}"<< '\n';
                 break;
             }
         }
@@ -1006,59 +1039,59 @@ void Remember::save() {
         if (a.focushiddenstate_remember || a.iconhiddenstate_remember) {
             if (a.focushiddenstate_remember && a.iconhiddenstate_remember &&
                 a.focushiddenstate == a.iconhiddenstate)
-                apps_file << "  [Hidden]\t{" << ((a.focushiddenstate)?"yes":"no") << "}" << endl;
+                apps_file << "  [Hidden]\t{" << ((a.focushiddenstate)?"yes":"no") << "}" << '\n';
             else if (a.focushiddenstate_remember) {
-                apps_file << "  [FocusHidden]\t{" << ((a.focushiddenstate)?"yes":"no") << "}" << endl;
+                apps_file << "  [FocusHidden]\t{" << ((a.focushiddenstate)?"yes":"no") << "}" << '\n';
             } else if (a.iconhiddenstate_remember) {
-                apps_file << "  [IconHidden]\t{" << ((a.iconhiddenstate)?"yes":"no") << "}" << endl;
+                apps_file << "  [IconHidden]\t{" << ((a.iconhiddenstate)?"yes":"no") << "}" << '\n';
             }
         }
         if (a.stuckstate_remember) {
-            apps_file << "  [Sticky]\t{" << ((a.stuckstate)?"yes":"no") << "}" << endl;
+            apps_file << "  [Sticky]\t{" << ((a.stuckstate)?"yes":"no") << "}" << '\n';
         }
         if (a.focusnewwindow_remember) {
-            apps_file << "  [FocusNewWindow]\t{" << ((a.focusnewwindow)?"yes":"no") << "}" << endl;
+            apps_file << "  [FocusNewWindow]\t{" << ((a.focusnewwindow)?"yes":"no") << "}" << '\n';
         }
         if (a.minimizedstate_remember) {
-            apps_file << "  [Minimized]\t{" << ((a.minimizedstate)?"yes":"no") << "}" << endl;
+            apps_file << "  [Minimized]\t{" << ((a.minimizedstate)?"yes":"no") << "}" << '\n';
         }
         if (a.maximizedstate_remember) {
             apps_file << "  [Maximized]\t{";
             switch (a.maximizedstate) {
             case WindowState::MAX_FULL:
-                apps_file << "yes" << "}" << endl;
+                apps_file << "yes" << "}" << '\n';
                 break;
             case WindowState::MAX_HORZ:
-                apps_file << "horz" << "}" << endl;
+                apps_file << "horz" << "}" << '\n';
                 break;
             case WindowState::MAX_VERT:
-                apps_file << "vert" << "}" << endl;
+                apps_file << "vert" << "}" << '\n';
                 break;
             case WindowState::MAX_NONE:
             default:
-                apps_file << "no" << "}" << endl;
+                apps_file << "no" << "}" << '\n';
                 break;
             }
         }
         if (a.fullscreenstate_remember) {
-            apps_file << "  [Fullscreen]\t{" << ((a.fullscreenstate)?"yes":"no") << "}" << endl;
+            apps_file << "  [Fullscreen]\t{" << ((a.fullscreenstate)?"yes":"no") << "}" << '\n';
         }
         if (a.jumpworkspace_remember) {
-            apps_file << "  [Jump]\t{" << ((a.jumpworkspace)?"yes":"no") << "}" << endl;
+            apps_file << "  [Jump]\t{" << ((a.jumpworkspace)?"yes":"no") << "}" << '\n';
         }
         if (a.layer_remember) {
-            apps_file << "  [Layer]\t{" << a.layer << "}" << endl;
+            apps_file << "  [Layer]\t{" << a.layer << "}" << '\n';
         }
         if (a.save_on_close_remember) {
-            apps_file << "  [Close]\t{" << ((a.save_on_close)?"yes":"no") << "}" << endl;
+            apps_file << "  [Close]\t{" << ((a.save_on_close)?"yes":"no") << "}" << '\n';
         }
         if (a.alpha_remember) {
             if (a.focused_alpha == a.unfocused_alpha)
-                apps_file << "  [Alpha]\t{" << a.focused_alpha << "}" << endl;
+                apps_file << "  [Alpha]\t{" << a.focused_alpha << "}" << '\n';
             else
-                apps_file << "  [Alpha]\t{" << a.focused_alpha << " " << a.unfocused_alpha << "}" << endl;
+                apps_file << "  [Alpha]\t{" << a.focused_alpha << " " << a.unfocused_alpha << "}" << '\n';
         }
-        apps_file << "[end]" << endl;
+        apps_file << "[end]" << '\n';
     }
     apps_file.close();
     // update timestamp to avoid unnecessary reload
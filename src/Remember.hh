@@ -29,6 +29,7 @@
 #include "AtomHandler.hh"
 #include "ClientPattern.hh"
 
+#include "FbTk/Timer.hh"
 
 #include <map>
 #include <list>
@@ -108,8 +109,10 @@ public:
     FluxboxWindow* findGroup(Application *, BScreen &screen);
 
     void reconfigure();
+    /// reloads the apps file if it changed, looks at it once per event batch
     void checkReload();
     void reload();
+    /// writes the apps file once the event queue is idle
     void save();
 
     bool isRemembered(WinClient &win, Attribute attrib);
@@ -151,6 +154,10 @@ public:
     static Remember &instance() { return *s_instance; }
 
 private:
+    /// write out a pending save right away
+    void flushSave();
+    void writeApps();
+    void expireCheck() { m_checked = false; }
 
     std::auto_ptr<Patterns> m_pats;
     Clients m_clients;
@@ -159,6 +166,9 @@ private:
     static Remember *s_instance;
 
     FbTk::AutoReloadHelper* m_reloader;
+    bool m_checked; ///< apps file was already checked in this event batch
+    FbTk::Timer m_check_timer;
+    FbTk::Timer m_save_timer; ///< running while a save is pending
 };
 
 #endif // REMEMBER_HH
@@ -0,0 +1,351 @@
+// RemoteControl.cc for Fluxbox Window Manager
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "RemoteControl.hh"
+
+#include "fluxbox.hh"
+#include "Screen.hh"
+#include "Debug.hh"
+
+#include "FbTk/CommandParser.hh"
+#include "FbTk/StringUtil.hh"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifdef HAVE_CSTRING
+  #include <cstring>
+#else
+  #include <string.h>
+#endif
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using std::string;
+using std::cerr;
+using std::endl;
+
+namespace {
+
+// a client that never sends a newline doesn't get to eat our memory
+const size_t MAX_LINE_LENGTH = 64 * 1024;
+// neither does a client that never reads its replies or events
+const size_t MAX_PENDING_OUTPUT = 1024 * 1024;
+
+void setupDescriptor(int fd) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+bool remoteActionsAllowed() {
+    const Fluxbox::ScreenList screens = Fluxbox::instance()->screenList();
+    Fluxbox::ScreenList::const_iterator it = screens.begin();
+    for (; it != screens.end(); ++it) {
+        if ((*it)->allowRemoteActions())
+            return true;
+    }
+    return false;
+}
+
+} // end anonymous namespace
+
+RemoteControl::RemoteControl(const string &path):
+    m_fd(-1),
+    m_path(path),
+    m_dev(0),
+    m_ino(0) {
+
+    sockaddr_un addr;
+    if (m_path.size() >= sizeof(addr.sun_path)) {
+        cerr<<"RemoteControl: socket path too long: "<<m_path<<endl;
+        return;
+    }
+
+    m_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_fd == -1) {
+        perror("RemoteControl: socket");
+        return;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, m_path.c_str());
+
+    // there can only be one window manager per display, so anything
+    // still at this path is left over from a previous run, unless
+    // somebody still listens on it
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    bool in_use = probe != -1 &&
+        connect(probe, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0;
+    if (probe != -1)
+        close(probe);
+    if (in_use) {
+        cerr<<"RemoteControl: "<<m_path<<" is in use"<<endl;
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    unlink(m_path.c_str());
+
+    // only the user is allowed to talk to us
+    mode_t old_umask = umask(0077);
+    int ret = bind(m_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    umask(old_umask);
+
+    if (ret == -1 || listen(m_fd, 16) == -1) {
+        perror("RemoteControl: bind");
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+
+    struct stat buf;
+    if (stat(m_path.c_str(), &buf) == 0) {
+        m_dev = buf.st_dev;
+        m_ino = buf.st_ino;
+    }
+
+    setupDescriptor(m_fd);
+    FbTk::FdHandler::instance().registerHandler(m_fd, this);
+
+    fbdbg<<"RemoteControl: listening on "<<m_path<<endl;
+}
+
+RemoteControl::~RemoteControl() {
+    while (!m_clients.empty())
+        closeClient(m_clients.begin()->first);
+
+    if (m_fd != -1) {
+        FbTk::FdHandler::instance().unregisterHandler(m_fd);
+        close(m_fd);
+        // another fluxbox may have replaced it meanwhile
+        struct stat buf;
+        if (stat(m_path.c_str(), &buf) == 0 &&
+            buf.st_dev == m_dev && buf.st_ino == m_ino)
+            unlink(m_path.c_str());
+    }
+}
+
+string RemoteControl::socketPath(const string &dir, const string &display_name,
+                                 const string &host) {
+    string name(display_name);
+    if (!host.empty())
+        name += "@" + host;
+    // e.g. launchd style display names contain a full path
+    std::replace(name.begin(), name.end(), '/', '_');
+    return dir + "/fluxbox-" + name + ".socket";
+}
+
+void RemoteControl::handleFdEvent(int fd) {
+    if (fd == m_fd) {
+        acceptClient();
+        return;
+    }
+
+    Clients::iterator it = m_clients.find(fd);
+    if (it == m_clients.end())
+        return;
+
+    if (!it->second.closing && it->second.output.size() < MAX_PENDING_OUTPUT)
+        readClient(fd, it->second);
+    else
+        flushClient(fd, it->second);
+}
+
+void RemoteControl::acceptClient() {
+    int fd = accept(m_fd, 0, 0);
+    if (fd == -1)
+        return;
+
+    setupDescriptor(fd);
+    m_clients[fd] = Client();
+    FbTk::FdHandler::instance().registerHandler(fd, this);
+}
+
+void RemoteControl::readClient(int fd, Client &client) {
+    // don't read further ahead than a single line, whatever else the
+    // client sends waits in the socket until we get to it
+    char buf[4096];
+    while (client.input.size() < MAX_LINE_LENGTH) {
+        ssize_t len = recv(fd, buf, sizeof(buf), 0);
+        if (len > 0) {
+            client.input.append(buf, len);
+            continue;
+        }
+        if (len == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            client.closing = true;
+        break;
+    }
+
+    if (!flushClient(fd, client))
+        return;
+
+    if (client.input.size() >= MAX_LINE_LENGTH &&
+        client.input.find('\n') == string::npos)
+        closeClient(fd);
+}
+
+void RemoteControl::executeInput(Client &client) {
+    // execute complete lines in order, but only as long as the
+    // client keeps up with reading the replies
+    string::size_type start = 0, end;
+    while (client.output.size() < MAX_PENDING_OUTPUT &&
+           (end = client.input.find('\n', start)) != string::npos) {
+        string line = client.input.substr(start, end - start);
+        start = end + 1;
+        FbTk::StringUtil::removeTrailingWhitespace(line);
+        if (!line.empty())
+            client.output += execute(client, line);
+    }
+    client.input.erase(0, start);
+
+    // a final line without newline still counts, if the peer is done
+    if (client.closing && !client.input.empty() &&
+        client.output.size() < MAX_PENDING_OUTPUT &&
+        client.input.find('\n') == string::npos) {
+        client.output += execute(client, client.input);
+        client.input.clear();
+    }
+}
+
+bool RemoteControl::flushClient(int fd, Client &client) {
+    executeInput(client);
+    while (!client.output.empty()) {
+        ssize_t len = send(fd, client.output.data(), client.output.size(),
+                           MSG_NOSIGNAL);
+        if (len <= 0) {
+            if (len == -1 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+                              errno == EINTR))
+                break;
+            closeClient(fd);
+            return false;
+        }
+        client.output.erase(0, len);
+        if (client.output.empty())
+            executeInput(client);
+    }
+
+    if (client.output.empty() && client.closing) {
+        closeClient(fd);
+        return false;
+    }
+
+    FbTk::FdHandler::instance().setReadInterest(fd,
+        !client.closing && client.output.size() < MAX_PENDING_OUTPUT);
+    FbTk::FdHandler::instance().setWriteInterest(fd, !client.output.empty());
+    return true;
+}
+
+void RemoteControl::closeClient(int fd) {
+    FbTk::FdHandler::instance().unregisterHandler(fd);
+    close(fd);
+    m_clients.erase(fd);
+}
+
+bool RemoteControl::hasSubscribers(const string &event) const {
+    Clients::const_iterator it = m_clients.begin();
+    Clients::const_iterator it_end = m_clients.end();
+    for (; it != it_end; ++it) {
+        const Client &client = it->second;
+        if (client.subscribed && !client.closing &&
+            (client.events.empty() || client.events.count(event)))
+            return true;
+    }
+    return false;
+}
+
+void RemoteControl::publish(const string &event, const string &fields) {
+    // this may be called from within a command a client sent us, so
+    // just queue the line and let the event loop do the sending
+    Clients::iterator it = m_clients.begin();
+    Clients::iterator it_end = m_clients.end();
+    for (; it != it_end; ++it) {
+        Client &client = it->second;
+        if (!client.subscribed || client.closing ||
+            !(client.events.empty() || client.events.count(event)))
+            continue;
+
+        if (client.output.size() > MAX_PENDING_OUTPUT) {
+            fbdbg<<"RemoteControl: dropping subscriber that doesn't read"<<endl;
+            client.output.clear();
+            // nothing else it sent gets executed either
+            client.input.clear();
+            client.closing = true;
+            FbTk::FdHandler::instance().setReadInterest(it->first, false);
+        } else {
+            // counted per client, so gaps mean lost events even with a filter
+            client.output += "{\"seq\":";
+            client.output += FbTk::StringUtil::number2String(++client.seq);
+            client.output += ',';
+            client.output += fields;
+            client.output += "}\n";
+        }
+
+        FbTk::FdHandler::instance().setWriteInterest(it->first, true);
+    }
+}
+
+string RemoteControl::execute(Client &client, const string &line) {
+    string command, args;
+    FbTk::StringUtil::getFirstWord(line, command, args);
+    if (FbTk::StringUtil::toLower(command) == "subscribe") {
+        // events don't tell anything the X server doesn't,
+        // so they don't depend on allowRemoteActions
+        client.subscribed = true;
+        client.events.clear();
+        std::vector<string> events;
+        FbTk::StringUtil::stringtok(events, FbTk::StringUtil::toLower(args));
+        client.events.insert(events.begin(), events.end());
+        return "ok\n";
+    }
+
+    if (FbTk::StringUtil::toLower(command) == "stats") {
+        // neither do the statistics
+        std::ostringstream reply;
+        reply<<"ok ";
+        Fluxbox::instance()->dumpStatsJSON(reply);
+        reply<<"\n";
+        return reply.str();
+    }
+
+    if (!remoteActionsAllowed())
+        return "error remote actions are disabled\n";
+
+    FbTk::RefCount<FbTk::Command<void> > cmd(
+        FbTk::CommandParser<void>::instance().parseCached(line, false));
+    if (!cmd)
+        return "error unknown command\n";
+
+    cmd->execute();
+    return "ok\n";
+}
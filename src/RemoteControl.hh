@@ -0,0 +1,107 @@
+// RemoteControl.hh for Fluxbox Window Manager
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef REMOTECONTROL_HH
+#define REMOTECONTROL_HH
+
+#include "FbTk/FdHandler.hh"
+#include "FbTk/NotCopyable.hh"
+
+#include <map>
+#include <set>
+#include <string>
+#include <sys/types.h>
+
+/// Unix domain socket that accepts key commands from fluxbox-remote
+/**
+ * Clients write one command per line and get one reply line per command,
+ * either "ok" or "error <reason>". Any number of commands may be sent
+ * in one write without waiting for the replies in between; they are
+ * executed in order. Commands run untrusted, the same way as commands
+ * sent through the _FLUXBOX_ACTION property, and only when
+ * allowRemoteActions is enabled.
+ *
+ * The line "subscribe [event ...]" turns the connection into an event
+ * stream: from then on, every matching event published through publish()
+ * is sent as one line, see EventStream for the events. Without arguments
+ * the client gets all events.
+ *
+ * The line "stats" is answered with "ok" followed by a json object with
+ * counters like the number of X requests sent so far.
+ */
+class RemoteControl: public FbTk::FdEventHandler, private FbTk::NotCopyable {
+public:
+    /// creates the socket at @a path, replacing any stale one
+    explicit RemoteControl(const std::string &path);
+    ~RemoteControl();
+
+    /**
+     * @return socket path for @a display_name inside @a dir, @a host
+     * is added to the name for a directory shared between machines
+     */
+    static std::string socketPath(const std::string &dir,
+                                  const std::string &display_name,
+                                  const std::string &host = "");
+
+    bool isListening() const { return m_fd != -1; }
+    const std::string &path() const { return m_path; }
+
+    void handleFdEvent(int fd);
+
+    /// @return true if any client subscribed to @a event
+    bool hasSubscribers(const std::string &event) const;
+    /**
+     * queues @a event for all clients subscribed to it, as a json object
+     * with the members @a fields, preceded by the client's own "seq"
+     */
+    void publish(const std::string &event, const std::string &fields);
+
+private:
+    struct Client {
+        Client(): closing(false), subscribed(false), seq(0) { }
+        std::string input; ///< received, but not yet complete line
+        std::string output; ///< replies not yet sent
+        bool closing; ///< peer is done sending, close after flushing
+        bool subscribed; ///< wants events
+        std::set<std::string> events; ///< subscribed events, empty for all
+        unsigned long seq; ///< number of events sent to this client
+    };
+    typedef std::map<int, Client> Clients;
+
+    void acceptClient();
+    void readClient(int fd, Client &client);
+    /// executes received lines while there is room for the replies
+    void executeInput(Client &client);
+    /// sends pending replies and executes more lines as they go out
+    /// @return false if the client was closed
+    bool flushClient(int fd, Client &client);
+    void closeClient(int fd);
+    /// executes a single command line, @return reply line
+    std::string execute(Client &client, const std::string &line);
+
+    int m_fd; ///< listening socket
+    std::string m_path;
+    dev_t m_dev; ///< the socket we created, so we only ever remove that
+    ino_t m_ino;
+    Clients m_clients;
+};
+
+#endif // REMOTECONTROL_HH
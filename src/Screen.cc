@@ -56,10 +56,12 @@
 #include "RectangleUtil.hh"
 #include "FbCommands.hh"
 #include "SystemTray.hh"
+#include "Xutil.hh"
 #include "Debug.hh"
 
 #include "FbTk/I18n.hh"
 #include "FbTk/FbWindow.hh"
+#include "FbTk/PropertyPrefetch.hh"
 #include "FbTk/SimpleCommand.hh"
 #include "FbTk/MultLayers.hh"
 #include "FbTk/LayerItem.hh"
@@ -596,28 +598,36 @@ void BScreen::initWindows() {
     Display *disp = FbTk::App::instance()->display();
     XQueryTree(disp, rootWindow().window(), &r, &p, &children, &nchild);
 
+    // ask for the hints of all children in one round trip instead of
+    // one round trip per child and hint
+    FbTk::PropertyPrefetch prefetch(disp);
+    typedef std::map<Window, unsigned int> ChildIndex;
+    ChildIndex child_index;
+    for (unsigned int i = 0; i < nchild; i++) {
+        prefetch.add(children[i], XA_WM_HINTS);
+        prefetch.add(children[i], XA_WM_TRANSIENT_FOR);
+        child_index[children[i]] = i;
+    }
+    prefetch.fetch();
+
     // preen the window list of all icon windows... for better dockapp support
     for (unsigned int i = 0; i < nchild; i++) {
 
         if (children[i] == None)
             continue;
 
-        XWMHints *wmhints = XGetWMHints(disp, children[i]);
+        XWMHints wmhints;
+        if (Xutil::getWMHints(children[i], wmhints) &&
+            (wmhints.flags & IconWindowHint) &&
+            wmhints.icon_window != children[i]) {
+            ChildIndex::iterator it = child_index.find(wmhints.icon_window);
+            if (it != child_index.end() && children[it->second] != None) {
 
-        if (wmhints) {
-            if ((wmhints->flags & IconWindowHint) &&
-                (wmhints->icon_window != children[i]))
-                for (unsigned int j = 0; j < nchild; j++) {
-                    if (children[j] == wmhints->icon_window) {
+                fbdbg<<"BScreen::initWindows(): children[j] = 0x"<<hex<<children[it->second]<<dec<<endl;
+                fbdbg<<"BScreen::initWindows(): = icon_window"<<endl;
 
-                        fbdbg<<"BScreen::initWindows(): children[j] = 0x"<<hex<<children[j]<<dec<<endl;
-                        fbdbg<<"BScreen::initWindows(): = icon_window"<<endl;
-
-                        children[j] = None;
-                        break;
-                    }
-                }
-            XFree(wmhints);
+                children[it->second] = None;
+            }
         }
 
     }
@@ -651,7 +661,7 @@ void BScreen::initWindows() {
 
         // if we have a transient_for window and it isn't created yet...
         // postpone creation of this window until after all others
-        if (XGetTransientForHint(disp, children[i], &transient_for) &&
+        if (Xutil::getTransientForHint(children[i], transient_for) &&
             fluxbox->searchWindow(transient_for) == 0 && !safety_flag) {
             // add this window back to the beginning of the list of children
             children[num_transients] = children[i];
@@ -774,9 +784,10 @@ void BScreen::propertyNotify(Atom atom) {
                     &ret_bytes_after, (unsigned char **)&str);
             }
 
-            static std::auto_ptr<FbTk::Command<void> > cmd(0);
-            cmd.reset(FbTk::CommandParser<void>::instance().parse(str, false));
-            if (cmd.get())
+            // remote actions tend to repeat, so let the parser cache them
+            FbTk::RefCount<FbTk::Command<void> > cmd(
+                FbTk::CommandParser<void>::instance().parseCached(str, false));
+            if (cmd)
                 cmd->execute();
             XFree(str);
 
@@ -1068,6 +1079,11 @@ void BScreen::changeWorkspaceID(unsigned int id, bool revert) {
         id == m_current_workspace->workspaceID())
         return;
 
+#ifdef DEBUG
+    timeval switch_start;
+    gettimeofday(&switch_start, 0);
+#endif // DEBUG
+
     /* Ignore all EnterNotify events until the pointer actually moves */
     this->focusControl().ignoreAtPointer();
 
@@ -1083,10 +1099,8 @@ void BScreen::changeWorkspaceID(unsigned int id, bool revert) {
     Workspace *old = currentWorkspace();
     m_current_workspace = getWorkspace(id);
 
-    // we show new workspace first in order to appear faster
-    currentWorkspace()->showAll();
-
-    // reassociate all windows that are stuck to the new workspace
+    // reassociate all windows that are stuck to the new workspace before
+    // switching; they stay mapped and are skipped by showAll() / hideAll()
     Workspace::Windows wins = old->windowList();
     Workspace::Windows::iterator it = wins.begin();
     for (; it != wins.end(); ++it) {
@@ -1102,6 +1116,14 @@ void BScreen::changeWorkspaceID(unsigned int id, bool revert) {
             (*icon_it)->setWorkspace(id);
     }
 
+    // map the new workspace and unmap the old one as a single batch, so
+    // the server (and any compositor) never paints a half switched desktop
+    // counted, a move in progress may already hold the grab
+    Fluxbox::instance()->grab();
+
+    // we show new workspace first in order to appear faster
+    currentWorkspace()->showAll();
+
     if (focused && focused->isMoving() && doOpaqueMove())
         focused->focus();
     else if (revert)
@@ -1109,8 +1131,18 @@ void BScreen::changeWorkspaceID(unsigned int id, bool revert) {
 
     old->hideAll(false);
 
+    Fluxbox::instance()->ungrab();
+
     FbTk::App::instance()->sync(false);
 
+#ifdef DEBUG
+    timeval switch_end;
+    gettimeofday(&switch_end, 0);
+    fbdbg<<"changeWorkspaceID("<<old->workspaceID()<<" -> "<<id<<") took "
+         <<(switch_end.tv_sec - switch_start.tv_sec) * 1000000 +
+           (switch_end.tv_usec - switch_start.tv_usec)<<" usec"<<endl;
+#endif // DEBUG
+
     m_currentworkspace_sig.emit(*this);
 
     // do this after atom handlers, so scripts can access new workspace number
@@ -1168,7 +1200,7 @@ bool BScreen::isKdeDockapp(Window client) const {
     unsigned long *data = 0, uljunk;
     Display *disp = FbTk::App::instance()->display();
     // Check if KDE v2.x dock applet
-    if (XGetWindowProperty(disp, client,
+    if (FbTk::PropertyPrefetch::getProperty(disp, client,
                            XInternAtom(FbTk::App::instance()->display(),
                                        "_KDE_NET_WM_SYSTEM_TRAY_WINDOW_FOR", False),
                            0l, 1l, False,
@@ -1185,7 +1217,7 @@ bool BScreen::isKdeDockapp(Window client) const {
     if (!iskdedockapp) {
         Atom kwm1 = XInternAtom(FbTk::App::instance()->display(),
                                 "KWM_DOCKWINDOW", False);
-        if (XGetWindowProperty(disp, client,
+        if (FbTk::PropertyPrefetch::getProperty(disp, client,
                                kwm1, 0l, 1l, False,
                                kwm1, &ajunk, &ijunk, &uljunk,
                                &uljunk, (unsigned char **) &data) == Success && data) {
@@ -1233,6 +1265,15 @@ bool BScreen::addKdeDockapp(Window client) {
 FluxboxWindow *BScreen::createWindow(Window client) {
     FbTk::App::instance()->sync(false);
 
+    // read everything we are going to look at in one round trip,
+    // instead of one for each property
+    Display *disp = FbTk::App::instance()->display();
+    FbTk::PropertyPrefetch prefetch(disp, client);
+    prefetch.add(XInternAtom(disp, "_KDE_NET_WM_SYSTEM_TRAY_WINDOW_FOR", False));
+    prefetch.add(XInternAtom(disp, "KWM_DOCKWINDOW", False));
+    WinClient::prefetchProperties(prefetch);
+    Fluxbox::instance()->prefetchProperties(prefetch);
+    prefetch.fetch();
 
     if (isKdeDockapp(client) && addKdeDockapp(client)) {
         return 0; // dont create a FluxboxWindow for this one
@@ -0,0 +1,71 @@
+// StartupProfiler.cc for Fluxbox Window Manager
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#include "StartupProfiler.hh"
+
+#include <iomanip>
+#include <iostream>
+
+using std::endl;
+using std::setw;
+
+namespace {
+
+long usecBetween(const timeval &from, const timeval &to) {
+    return (to.tv_sec - from.tv_sec) * 1000000L + (to.tv_usec - from.tv_usec);
+}
+
+} // end anonymous namespace
+
+StartupProfiler::StartupProfiler(): m_finished(false) {
+    gettimeofday(&m_start, 0);
+    m_last = m_start;
+}
+
+void StartupProfiler::mark(const std::string &phase) {
+    if (m_finished)
+        return;
+
+    timeval now;
+    gettimeofday(&now, 0);
+
+    Phase p;
+    p.name = phase;
+    p.usec = usecBetween(m_last, now);
+    m_phases.push_back(p);
+    m_last = now;
+}
+
+void StartupProfiler::finish() {
+    m_finished = true;
+}
+
+long StartupProfiler::totalUsec() const {
+    return usecBetween(m_start, m_last);
+}
+
+void StartupProfiler::print(std::ostream &os) const {
+    os<<"startup:"<<endl;
+    for (size_t i = 0; i < m_phases.size(); ++i)
+        os<<"  "<<setw(10)<<m_phases[i].usec<<" usec  "<<m_phases[i].name<<endl;
+    os<<"  "<<setw(10)<<totalUsec()<<" usec  total"<<endl;
+}
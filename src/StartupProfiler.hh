@@ -0,0 +1,62 @@
+// StartupProfiler.hh for Fluxbox Window Manager
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef STARTUPPROFILER_HH
+#define STARTUPPROFILER_HH
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <sys/time.h>
+
+/// Measures how long the phases of the startup take
+/**
+ * The time between two calls to mark() is accounted to the phase named
+ * in the second call. The result is written to the debug output once
+ * fluxbox is up, and at any time with the "dumpstats" command.
+ */
+class StartupProfiler {
+public:
+    StartupProfiler();
+
+    /// ends the current phase and names it @a phase
+    void mark(const std::string &phase);
+    /// ends the last phase, later marks are ignored
+    void finish();
+    bool isFinished() const { return m_finished; }
+
+    /// @return time from construction to the last mark
+    long totalUsec() const;
+    void print(std::ostream &os) const;
+
+private:
+    struct Phase {
+        std::string name;
+        long usec;
+    };
+    std::vector<Phase> m_phases;
+    timeval m_start, m_last;
+    bool m_finished;
+};
+
+#endif // STARTUPPROFILER_HH
@@ -30,7 +30,9 @@
 #include "Debug.hh"
 
 #include "FbTk/EventManager.hh"
+#include "FbTk/MemFun.hh"
 #include "FbTk/MultLayers.hh"
+#include "FbTk/PropertyPrefetch.hh"
 
 #include <iostream>
 #include <algorithm>
@@ -93,10 +95,16 @@ WinClient::WinClient(Window win, BScreen &screen, FluxboxWindow *fbwin):
                      send_close_message(false),
                      m_title_override(false),
                      m_icon_override(false),
+                     m_wm_name_changed(false),
+                     m_title_property(None),
                      m_window_type(WindowState::TYPE_NORMAL),
                      m_mwm_hint(0),
                      m_strut(0) {
 
+    m_last_title_update.tv_sec = m_last_title_update.tv_usec = 0;
+    m_title_update_timer.setFunctor(FbTk::MemFun(*this, &WinClient::flushTitleUpdate));
+    m_title_update_timer.fireOnce(true);
+
     old_bw = borderWidth();
     updateWMProtocols();
     updateMWMHints();
@@ -125,6 +133,22 @@ WinClient::WinClient(Window win, BScreen &screen, FluxboxWindow *fbwin):
     updateTransientInfo();
 }
 
+void WinClient::prefetchProperties(FbTk::PropertyPrefetch &prefetch) {
+    Display *disp = FbTk::App::instance()->display();
+    FbAtoms *fbatoms = FbAtoms::instance();
+
+    prefetch.add(fbatoms->getWMProtocolsAtom());
+    prefetch.add(fbatoms->getWMStateAtom());
+    prefetch.add(fbatoms->getMWMHintsAtom());
+    prefetch.add(XA_WM_HINTS);
+    prefetch.add(XA_WM_NORMAL_HINTS);
+    prefetch.add(XA_WM_CLASS);
+    prefetch.add(XA_WM_NAME);
+    prefetch.add(XA_WM_TRANSIENT_FOR);
+    prefetch.add(XInternAtom(disp, "WM_WINDOW_ROLE", False));
+    prefetch.add(XInternAtom(disp, "_FLUXBOX_GROUP_LEFT", False));
+}
+
 WinClient::~WinClient() {
     fbdbg<<__FILE__<<"(~"<<__FUNCTION__<<")[this="<<this<<"]"<<endl;
 
@@ -227,8 +251,7 @@ string WinClient::getWMRole() const {
 
 void WinClient::updateWMClassHint() {
 
-    m_instance_name = Xutil::getWMClassName(window());
-    m_class_name = Xutil::getWMClassClass(window());
+    Xutil::getWMClass(window(), m_instance_name, m_class_name);
 }
 
 void WinClient::updateTransientInfo() {
@@ -242,7 +265,7 @@ void WinClient::updateTransientInfo() {
     transient_for = 0;
     // determine if this is a transient window
     Window win = 0;
-    if (!XGetTransientForHint(display(), window(), &win)) {
+    if (!Xutil::getTransientForHint(window(), win)) {
 
         fbdbg<<__FUNCTION__<<": window() = 0x"<<hex<<window()<<dec<<"Failed to read transient for hint."<<endl;
         return;
@@ -313,16 +336,64 @@ void WinClient::updateTitle() {
     if (m_title_override)
         return;
 
-    m_title.setLogical(FbTk::FbString(Xutil::getWMName(window()), 0, 512));
+    FbTk::FbString title(Xutil::getWMName(window()), 0, 512);
+    if (title == m_title.logical())
+        return;
+
+    m_title.setLogical(title);
     titleSig().emit(m_title.logical(), *this);
 }
 
 void WinClient::setTitle(const FbTk::FbString &title) {
+    if (m_title_override && title == m_title.logical())
+        return;
+
     m_title.setLogical(title);
     m_title_override = true;
     titleSig().emit(m_title.logical(), *this);
 }
 
+void WinClient::scheduleTitleUpdate(Atom property) {
+    if (property == XA_WM_NAME)
+        m_wm_name_changed = true;
+    else
+        m_title_property = property;
+
+    if (m_title_update_timer.isTiming())
+        return;
+
+    // a timer of 0 fires as soon as the pending events are handled,
+    // so a burst of changes is read once
+    long delay = Fluxbox::instance()->getTitleUpdateInterval();
+    if (delay > 0) {
+        timeval now;
+        gettimeofday(&now, 0);
+        long elapsed = (now.tv_sec - m_last_title_update.tv_sec) * 1000 +
+            (now.tv_usec - m_last_title_update.tv_usec) / 1000;
+        delay = (elapsed >= 0 && elapsed < delay) ? delay - elapsed : 0;
+    } else
+        delay = 0;
+
+    m_title_update_timer.setTimeout(delay);
+    m_title_update_timer.start();
+}
+
+void WinClient::flushTitleUpdate() {
+    gettimeofday(&m_last_title_update, 0);
+
+    if (m_wm_name_changed) {
+        m_wm_name_changed = false;
+        updateTitle();
+    }
+
+    if (m_title_property != None) {
+        FbTk::FbString title = textProperty(m_title_property);
+        m_title_property = None;
+        if (!title.empty())
+            setTitle(title);
+    }
+}
+
 void WinClient::setIcon(const FbTk::PixmapWithMask& pm) {
 
     m_icon.pixmap().copy(pm.pixmap());
@@ -361,7 +432,8 @@ void WinClient::updateMWMHints() {
 }
 
 void WinClient::updateWMHints() {
-    XWMHints *wmhint = XGetWMHints(display(), window());
+    XWMHints hints;
+    XWMHints *wmhint = Xutil::getWMHints(window(), hints) ? &hints : 0;
     accepts_input = true;
     window_group = None;
     initial_state = NormalState;
@@ -409,16 +481,13 @@ void WinClient::updateWMHints() {
                 Fluxbox::instance()->attentionHandler().windowFocusChanged(*this);
             }
         }
-
-        XFree(wmhint);
     }
 }
 
 
 void WinClient::updateWMNormalHints() {
-    long icccm_mask;
     XSizeHints sizehint;
-    if (!XGetWMNormalHints(display(), window(), &sizehint, &icccm_mask))
+    if (!Xutil::getWMNormalHints(window(), sizehint))
         sizehint.flags = 0;
 
     normal_hint_flags = sizehint.flags;
@@ -549,15 +618,15 @@ void WinClient::setAttentionState(bool value) {
 
 void WinClient::updateWMProtocols() {
     Atom *proto = 0;
-    int num_return = 0;
+    unsigned long num_return = 0;
     FbAtoms *fbatoms = FbAtoms::instance();
 
-    if (XGetWMProtocols(display(), window(), &proto, &num_return)) {
+    if (Xutil::getWMProtocols(window(), proto, num_return)) {
 
         // defaults
         send_focus_message = false;
         send_close_message = false;
-        for (int i = 0; i < num_return; ++i) {
+        for (unsigned long i = 0; i < num_return; ++i) {
             if (proto[i] == fbatoms->getWMDeleteAtom())
                 send_close_message = true;
             else if (proto[i] == fbatoms->getWMTakeFocusAtom())
@@ -27,10 +27,17 @@
 
 #include "FbTk/FbWindow.hh"
 #include "FbTk/FbString.hh"
+#include "FbTk/Timer.hh"
+
+#include <sys/time.h>
 
 class BScreen;
 class Strut;
 
+namespace FbTk {
+class PropertyPrefetch;
+}
+
 /// Holds client window info 
 class WinClient: public Focusable, public FbTk::FbWindow {
 public:
@@ -47,6 +54,9 @@ public:
 
     ~WinClient();
 
+    /// adds the properties the constructor reads to @a prefetch
+    static void prefetchProperties(FbTk::PropertyPrefetch &prefetch);
+
     bool sendFocus(); // returns whether we sent a message or not 
                       // i.e. whether we assume the focus will get taken
     bool acceptsFocus() const; // will this window accept focus (according to hints)
@@ -61,6 +71,14 @@ public:
     // override the title with this
     void setTitle(const FbTk::FbString &title);
     void updateTitle();
+    /**
+       Reads the title from @a property later, once per event loop
+       iteration and at most every session.titleUpdateInterval ms, so
+       clients that change their title very often are not read and
+       redrawn for every change.  @a property is WM_NAME or a property
+       that overrides it, like _NET_WM_NAME.
+    */
+    void scheduleTitleUpdate(Atom property);
     /// updates transient window information
     void updateTransientInfo();
 
@@ -143,6 +161,8 @@ public:
 private:
     /// removes client from any waiting list and clears empty waiting lists
     void removeTransientFromWaitingList();
+    /// reads the titles scheduled with scheduleTitleUpdate
+    void flushTitleUpdate();
 
     // some transient of ours (or us) is modal
     void addModal() { ++m_modal_count; }
@@ -157,6 +177,11 @@ private:
     bool m_title_override;
     bool m_icon_override;
 
+    FbTk::Timer m_title_update_timer;
+    timeval m_last_title_update;
+    bool m_wm_name_changed; ///< WM_NAME changed since the last title update
+    Atom m_title_property; ///< overriding title property that changed, or None
+
     WindowState::WindowType m_window_type;
     MwmHints *m_mwm_hint;
     SizeHints m_size_hints;
@@ -231,20 +231,17 @@ private:
 /// helper class for some STL routines
 class ChangeProperty {
 public:
-    ChangeProperty(Display *disp, Atom prop, int mode,
-                   unsigned char *state, int num):m_disp(disp),
-                                                  m_prop(prop),
+    ChangeProperty(Atom prop, int mode,
+                   unsigned char *state, int num):m_prop(prop),
                                                   m_state(state),
                                                   m_num(num),
                                                   m_mode(mode){
 
     }
     void operator () (FbTk::FbWindow *win) {
-        XChangeProperty(m_disp, win->window(), m_prop, m_prop, 32, m_mode,
-                        m_state, m_num);
+        win->changeProperty(m_prop, m_prop, 32, m_mode, m_state, m_num);
     }
 private:
-    Display *m_disp;
     Atom m_prop;
     unsigned char *m_state;
     int m_num;
@@ -1837,8 +1834,7 @@ void FluxboxWindow::setState(unsigned long new_state, bool setting_up) {
     state[1] = (unsigned long) None;
 
     for_each(m_clientlist.begin(), m_clientlist.end(),
-             ChangeProperty(display,
-                                  FbAtoms::instance()->getWMStateAtom(),
+             ChangeProperty(FbAtoms::instance()->getWMStateAtom(),
                                   PropModeReplace,
                                   (unsigned char *)state, 2));
 
@@ -2095,7 +2091,7 @@ void FluxboxWindow::propertyNotifyEvent(WinClient &client, Atom atom) {
         // and we don't show icons anyway
         break;
     case XA_WM_NAME:
-        client.updateTitle();
+        client.scheduleTitleUpdate(atom);
         break;
 
     case XA_WM_NORMAL_HINTS: {
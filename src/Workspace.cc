@@ -120,8 +120,11 @@ int Workspace::removeWindow(FluxboxWindow *w, bool still_alive) {
 void Workspace::showAll() {
     Windows::iterator it = m_windowlist.begin();
     Windows::iterator it_end = m_windowlist.end();
-    for (; it != it_end; ++it)
-        (*it)->show();
+    for (; it != it_end; ++it) {
+        // stuck windows are already visible
+        if (! (*it)->isStuck())
+            (*it)->show();
+    }
 }
 
 
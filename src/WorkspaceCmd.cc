@@ -28,6 +28,7 @@
 #include "Screen.hh"
 #include "fluxbox.hh"
 #include "WinClient.hh"
+#include "GeometryTransaction.hh"
 #include "FocusControl.hh"
 #include "WindowCmd.hh"
 
@@ -85,6 +86,8 @@ void WindowListCmd::execute() {
                                             it_end = win_list.end();
         // save old value, so we can restore it later
         WinClient *old = WindowCmd<void>::client();
+        // e.g. maximizing every window shows up as one change
+        GeometryTransaction::Lock lock(*screen);
         for (; it != it_end; ++it) {
             if (typeid(**it) == typeid(FluxboxWindow))
                 WindowCmd<void>::setWindow((*it)->fbwindow());
@@ -426,15 +429,17 @@ void ArrangeWindowsCmd::execute() {
     unsigned int i;
     unsigned int j;
 
+    GeometryTransaction transaction(*screen);
+
     // place the shaded windows
     // TODO: until i resolve the shadedwindow->moveResize() issue to place
     // them in the same columns as the normal windows i just place the shaded
     // windows unchanged ontop of the current head
     for (i = 0, win = shaded_windows.begin(); win != shaded_windows.end(); ++win, ++i) {
         if (i & 1)
-            (*win)->move(x_offs, y_offs);
+            transaction.move(**win, x_offs, y_offs);
         else
-            (*win)->move(screen->maxRight(head) - (*win)->frame().width(), y_offs);
+            transaction.move(**win, screen->maxRight(head) - (*win)->frame().width(), y_offs);
 
         y_offs += (*win)->frame().height();
     }
@@ -471,12 +476,12 @@ void ArrangeWindowsCmd::execute() {
             }
 
             if (normal_windows.size() > 1) {
-                (*closest)->moveResize(x_offs + (*closest)->xOffset(),
+                transaction.moveResize(**closest, x_offs + (*closest)->xOffset(),
 			y_offs + (*closest)->yOffset(),
 			cal_width - (*closest)->widthOffset(),
 			cal_height - (*closest)->heightOffset());
             } else { // the last window gets everything that is left.
-                (*closest)->moveResize(x_offs + (*closest)->xOffset(),
+                transaction.moveResize(**closest, x_offs + (*closest)->xOffset(),
 			y_offs + (*closest)->yOffset(),
 			screen->maxRight(head) - x_offs - (*closest)->widthOffset(),
 			cal_height - (*closest)->heightOffset());
@@ -506,14 +511,16 @@ void ShowDesktopCmd::execute() {
                                            it_end = wins.end();
     unsigned int space = screen->currentWorkspaceID();
     unsigned int count = 0;
+    GeometryTransaction transaction(*screen);
     for (; it != it_end; ++it) {
         if (!(*it)->fbwindow()->isIconic() && ((*it)->fbwindow()->isStuck() ||
             (*it)->fbwindow()->workspaceNumber() == space) &&
             (*it)->fbwindow()->layerNum() < ResourceLayer::DESKTOP) {
-            (*it)->fbwindow()->iconify();
+            transaction.iconify(*(*it)->fbwindow());
             count++;
         }
     }
+    transaction.commit();
 
     if (count == 0) {
         BScreen::Icons icon_list = screen->iconList();
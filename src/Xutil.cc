@@ -22,9 +22,11 @@
 
 #include "Xutil.hh"
 #include "Debug.hh"
+#include "FbAtoms.hh"
 
 #include "FbTk/I18n.hh"
 #include "FbTk/App.hh"
+#include "FbTk/PropertyPrefetch.hh"
 
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
@@ -57,7 +59,7 @@ FbTk::FbString getWMName(Window window) {
     _FB_USES_NLS;
     FbTk::FbString name;
 
-    if (XGetWMName(display, window, &text_prop)) {
+    if (FbTk::PropertyPrefetch::getTextProperty(display, window, &text_prop, XA_WM_NAME)) {
         if (text_prop.value && text_prop.nitems > 0) {
             if (text_prop.encoding != XA_STRING) {
 
@@ -89,53 +91,198 @@ FbTk::FbString getWMName(Window window) {
 }
 
 
-// The name of this particular instance
-FbTk::FbString getWMClassName(Window win) {
-
-    XClassHint ch;
-    FbTk::FbString instance_name;
-
-    if (XGetClassHint(FbTk::App::instance()->display(), win, &ch) == 0) {
+namespace {
+
+// XGetClassHint, but served from a property prefetch if there is one
+bool readClassHint(Window win, FbTk::FbString &instance_name,
+                   FbTk::FbString &class_name) {
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    unsigned char *data = 0;
+
+    if (FbTk::PropertyPrefetch::getProperty(FbTk::App::instance()->display(),
+                                            win, XA_WM_CLASS, 0, 2048,
+                                            False, XA_STRING, &type, &format,
+                                            &nitems, &bytes_after,
+                                            &data) != Success ||
+        type != XA_STRING || format != 8 || data == 0) {
+        if (data)
+            XFree(data);
         fbdbg<<"Xutil: Failed to read class hint!"<<endl;
+        return false;
+    }
 
-        instance_name = "";
-    } else {
+    // "instance\0class\0"
+    const char *str = reinterpret_cast<const char *>(data);
+    size_t name_len = strlen(str);
+    instance_name = str;
+    if (name_len + 1 < nitems)
+        class_name = str + name_len + 1;
+    else
+        class_name = "";
 
-        XFree(ch.res_class);
+    XFree(data);
+    return true;
+}
 
-        if (ch.res_class != 0) {
-            instance_name = const_cast<char *>(ch.res_name);
-            XFree(ch.res_name);
-            ch.res_name = 0;
-        } else
-            instance_name = "";
+} // end anonymous namespace
+
+void getWMClass(Window win, FbTk::FbString &instance_name,
+                FbTk::FbString &class_name) {
+    if (!readClassHint(win, instance_name, class_name)) {
+        instance_name = "";
+        class_name = "";
     }
+}
 
+// The name of this particular instance
+FbTk::FbString getWMClassName(Window win) {
+    FbTk::FbString instance_name, class_name;
+    getWMClass(win, instance_name, class_name);
     return instance_name;
 }
 
 // the name of the general class of the app
 FbTk::FbString getWMClassClass(Window win) {
+    FbTk::FbString instance_name, class_name;
+    getWMClass(win, instance_name, class_name);
+    return class_name;
+}
 
-    XClassHint ch;
-    FbTk::FbString class_name;
+namespace {
+
+// XGetWindowProperty, but served from a property prefetch if there is one
+bool readProperty(Window win, Atom prop, long length, Atom req_type,
+                  Atom &type, int &format, unsigned long &nitems,
+                  unsigned char *&data) {
+    unsigned long bytes_after;
+    data = 0;
+    return FbTk::PropertyPrefetch::getProperty(FbTk::App::instance()->display(),
+                                               win, prop, 0, length, False,
+                                               req_type, &type, &format,
+                                               &nitems, &bytes_after,
+                                               &data) == Success;
+}
 
-    if (XGetClassHint(FbTk::App::instance()->display(), win, &ch) == 0) {
-        fbdbg<<"Xutil: Failed to read class hint!"<<endl;
-        class_name = "";
-    } else {
+} // end anonymous namespace
+
+bool getWMProtocols(Window win, Atom *&protocols, unsigned long &count) {
+    Atom type;
+    int format;
+    unsigned char *data;
+
+    protocols = 0;
+    if (!readProperty(win, FbAtoms::instance()->getWMProtocolsAtom(), 1000000,
+                      XA_ATOM, type, format, count, data) ||
+        type != XA_ATOM || format != 32) {
+        if (data)
+            XFree(data);
+        count = 0;
+        return false;
+    }
+
+    protocols = reinterpret_cast<Atom *>(data);
+    return true;
+}
+
+bool getTransientForHint(Window win, Window &transient_for) {
+    Atom type;
+    int format;
+    unsigned long nitems;
+    unsigned char *data;
+
+    transient_for = None;
+    bool ok = readProperty(win, XA_WM_TRANSIENT_FOR, 1, XA_WINDOW,
+                           type, format, nitems, data) &&
+        type == XA_WINDOW && format == 32 && nitems != 0 && data;
+    if (ok)
+        transient_for = *reinterpret_cast<Window *>(data);
+    if (data)
+        XFree(data);
+    return ok;
+}
+
+bool getWMHints(Window win, XWMHints &hints) {
+    // the property holds 9 elements, ICCCM 1.0 clients only set 8
+    const unsigned long num_elements = 9;
+    Atom type;
+    int format;
+    unsigned long nitems;
+    unsigned char *data;
+
+    if (!readProperty(win, XA_WM_HINTS, num_elements, XA_WM_HINTS,
+                      type, format, nitems, data) ||
+        type != XA_WM_HINTS || format != 32 || nitems < num_elements - 1 ||
+        data == 0) {
+        if (data)
+            XFree(data);
+        return false;
+    }
+
+    long *prop = reinterpret_cast<long *>(data);
+    hints.flags = prop[0];
+    hints.input = prop[1] ? True : False;
+    hints.initial_state = prop[2];
+    hints.icon_pixmap = prop[3];
+    hints.icon_window = prop[4];
+    hints.icon_x = prop[5];
+    hints.icon_y = prop[6];
+    hints.icon_mask = prop[7];
+    hints.window_group = nitems >= num_elements ? prop[8] : 0;
+
+    XFree(data);
+    return true;
+}
 
-        XFree(ch.res_name);
+bool getWMNormalHints(Window win, XSizeHints &hints) {
+    // ICCCM 1.0 clients set 15 elements, without base size and gravity
+    const unsigned long num_elements = 18;
+    const unsigned long old_num_elements = 15;
+    Atom type;
+    int format;
+    unsigned long nitems;
+    unsigned char *data;
+
+    if (!readProperty(win, XA_WM_NORMAL_HINTS, num_elements, XA_WM_SIZE_HINTS,
+                      type, format, nitems, data) ||
+        type != XA_WM_SIZE_HINTS || format != 32 ||
+        nitems < old_num_elements || data == 0) {
+        if (data)
+            XFree(data);
+        return false;
+    }
 
-        if (ch.res_class != 0) {
-            class_name = const_cast<char *>(ch.res_class);
-            XFree(ch.res_class);
-            ch.res_class = 0;
-        } else
-            class_name = "";
+    long *prop = reinterpret_cast<long *>(data);
+    long supplied = USPosition | USSize | PAllHints;
+    hints.x = prop[1];
+    hints.y = prop[2];
+    hints.width = prop[3];
+    hints.height = prop[4];
+    hints.min_width = prop[5];
+    hints.min_height = prop[6];
+    hints.max_width = prop[7];
+    hints.max_height = prop[8];
+    hints.width_inc = prop[9];
+    hints.height_inc = prop[10];
+    hints.min_aspect.x = prop[11];
+    hints.min_aspect.y = prop[12];
+    hints.max_aspect.x = prop[13];
+    hints.max_aspect.y = prop[14];
+    if (nitems >= num_elements) {
+        supplied |= PBaseSize | PWinGravity;
+        hints.base_width = prop[15];
+        hints.base_height = prop[16];
+        hints.win_gravity = prop[17];
+    } else {
+        hints.base_width = 0;
+        hints.base_height = 0;
+        hints.win_gravity = 0;
     }
+    hints.flags = prop[0] & supplied;
 
-    return class_name;
+    XFree(data);
+    return true;
 }
 
 } // end namespace Xutil
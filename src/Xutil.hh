@@ -24,15 +24,26 @@
 #define XUTIL_HH
 
 #include <X11/Xlib.h>
+#include <X11/Xutil.h>
 #include "FbTk/FbString.hh"
 
 namespace Xutil {
 
 FbTk::FbString getWMName(Window window);
 
+/// reads instance and class of WM_CLASS at once
+void getWMClass(Window win, FbTk::FbString &instance_name,
+                FbTk::FbString &class_name);
 FbTk::FbString getWMClassName(Window win);
 FbTk::FbString getWMClassClass(Window win);
 
+// same as the Xlib functions, but they can be answered
+// from a FbTk::PropertyPrefetch
+bool getWMProtocols(Window win, Atom *&protocols, unsigned long &count);
+bool getTransientForHint(Window win, Window &transient_for);
+bool getWMHints(Window win, XWMHints &hints);
+bool getWMNormalHints(Window win, XSizeHints &hints);
+
 
 } // end namespace Xutil
 
@@ -34,12 +34,17 @@
 #include "FbAtoms.hh"
 #include "FocusControl.hh"
 #include "Layer.hh"
+#include "RemoteControl.hh"
+#include "EventStream.hh"
 
 #include "defaults.hh"
 #include "Debug.hh"
 
 #include "FbTk/I18n.hh"
 #include "FbTk/Image.hh"
+#include "FbTk/PropertyPrefetch.hh"
+#include "FbTk/RequestCounter.hh"
+#include "FbTk/RenderQueue.hh"
 #include "FbTk/FileUtil.hh"
 #include "FbTk/ImageControl.hh"
 #include "FbTk/EventManager.hh"
@@ -56,6 +61,7 @@
 #include "FbTk/Compose.hh"
 #include "FbTk/KeyUtil.hh"
 #include "FbTk/MemFun.hh"
+#include "FbTk/MenuSearch.hh"
 
 //Use GNU extensions
 #ifndef	 _GNU_SOURCE
@@ -132,6 +138,7 @@
 #include <memory>
 #include <algorithm>
 #include <typeinfo>
+#include <iomanip>
 
 using std::cerr;
 using std::endl;
@@ -143,6 +150,9 @@ using std::bind2nd;
 using std::mem_fun;
 using std::equal_to;
 using std::hex;
+using std::setw;
+using std::left;
+using std::right;
 using std::dec;
 
 using namespace FbTk;
@@ -151,6 +161,23 @@ namespace {
 
 Window last_bad_window = None;
 
+const char *eventName(int type) {
+    static const char *names[] = {
+        "Extension", "Unused", "KeyPress", "KeyRelease", "ButtonPress",
+        "ButtonRelease", "MotionNotify", "EnterNotify", "LeaveNotify",
+        "FocusIn", "FocusOut", "KeymapNotify", "Expose", "GraphicsExpose",
+        "NoExpose", "VisibilityNotify", "CreateNotify", "DestroyNotify",
+        "UnmapNotify", "MapNotify", "MapRequest", "ReparentNotify",
+        "ConfigureNotify", "ConfigureRequest", "GravityNotify",
+        "ResizeRequest", "CirculateNotify", "CirculateRequest",
+        "PropertyNotify", "SelectionClear", "SelectionRequest",
+        "SelectionNotify", "ColormapNotify", "ClientMessage",
+        "MappingNotify", "GenericEvent"
+    };
+    const int num_names = sizeof(names) / sizeof(names[0]);
+    return (type >= 0 && type < num_names) ? names[type] : names[0];
+}
+
 // *** NOTE: if you want to debug here the X errors are
 //     coming from, you should turn on the XSynchronise call below
 int handleXErrors(Display *d, XErrorEvent *e) {
@@ -239,6 +266,7 @@ Fluxbox::Fluxbox(int argc, char **argv,
       m_rc_colors_per_channel(m_resourcemanager, 4,
                               "session.colorsPerChannel", "Session.ColorsPerChannel"),
       m_rc_double_click_interval(m_resourcemanager, 250, "session.doubleClickInterval", "Session.DoubleClickInterval"),
+      m_rc_title_update_interval(m_resourcemanager, 100, "session.titleUpdateInterval", "Session.TitleUpdateInterval"),
       m_rc_tabs_padding(m_resourcemanager, 0, "session.tabPadding", "Session.TabPadding"),
       m_rc_stylefile(m_resourcemanager, DEFAULTSTYLE, "session.styleFile", "Session.StyleFile"),
       m_rc_styleoverlayfile(m_resourcemanager, m_RC_PATH + "/overlay", "session.styleOverlay", "Session.StyleOverlay"),
@@ -246,6 +274,7 @@ Fluxbox::Fluxbox(int argc, char **argv,
       m_rc_keyfile(m_resourcemanager, m_RC_PATH + "/keys", "session.keyFile", "Session.KeyFile"),
       m_rc_slitlistfile(m_resourcemanager, m_RC_PATH + "/slitlist", "session.slitlistFile", "Session.SlitlistFile"),
       m_rc_appsfile(m_resourcemanager, m_RC_PATH + "/apps", "session.appsFile", "Session.AppsFile"),
+      m_rc_menusearch(m_resourcemanager, "itemstart", "session.menuSearch", "Session.MenuSearch"),
       m_rc_tabs_attach_area(m_resourcemanager, ATTACH_AREA_WINDOW, "session.tabsAttachArea", "Session.TabsAttachArea"),
       m_rc_cache_life(m_resourcemanager, 5, "session.cacheLife", "Session.CacheLife"),
       m_rc_cache_max(m_resourcemanager, 200, "session.cacheMax", "Session.CacheMax"),
@@ -327,7 +356,10 @@ Fluxbox::Fluxbox(int argc, char **argv,
     XRRQueryExtension(disp, &m_randr_event_type, &randr_error_base);
 #endif // HAVE_RANDR
 
+    m_startup_profiler.mark("setup");
+
     load_rc();
+    m_startup_profiler.mark("load resources");
 
     grab();
 
@@ -349,11 +381,13 @@ Fluxbox::Fluxbox(int argc, char **argv,
 
     // setup theme manager to have our style file ready to be scanned
     FbTk::ThemeManager::instance().load(getStyleFilename(), getStyleOverlayFilename());
+    m_startup_profiler.mark("load style");
 
     // Create keybindings handler and load keys file
     // Note: this needs to be done before creating screens
     m_key.reset(new Keys);
     m_key->reconfigure();
+    m_startup_profiler.mark("load keys");
 
     vector<int> screens;
     int i;
@@ -409,6 +443,7 @@ Fluxbox::Fluxbox(int argc, char **argv,
 
         // add to our list
         m_screen_list.push_back(screen);
+        m_startup_profiler.mark("create screen " + sc_nr);
     }
 
     if (m_screen_list.empty()) {
@@ -429,6 +464,11 @@ Fluxbox::Fluxbox(int argc, char **argv,
 #ifdef REMEMBER
     addAtomHandler(new Remember()); // for remembering window attribs
 #endif // REMEMBER
+    m_startup_profiler.mark("atom handlers");
+
+    // before the screens, so the event stream sees all windows
+    initRemoteControl();
+    m_startup_profiler.mark("remote control");
 
     // init all "screens"
     STLUtil::forAll(m_screen_list, bind1st(mem_fun(&Fluxbox::initScreen), this));
@@ -448,6 +488,11 @@ Fluxbox::Fluxbox(int argc, char **argv,
     }
 
     m_starting = false;
+    m_startup_profiler.mark("finish");
+    m_startup_profiler.finish();
+#ifdef DEBUG
+    m_startup_profiler.print(cerr);
+#endif // DEBUG
     //
     // For dumping theme items
     // FbTk::ThemeManager::instance().listItems();
@@ -463,20 +508,34 @@ Fluxbox::~Fluxbox() {
     // key commands cause a segfault when the LayerItem is destroyed
     m_key.reset(0);
 
+    if (m_remote.get() && m_remote->isListening()) {
+        Atom socket_atom = XInternAtom(display(), "_FLUXBOX_SOCKET", False);
+        ScreenList::iterator it = m_screen_list.begin();
+        for (; it != m_screen_list.end(); ++it)
+            (*it)->rootWindow().deleteProperty(socket_atom);
+    }
+
     leaveAll(); // leave all connections
 
     // destroy screens (after others, as they may do screen things)
     FbTk::STLUtil::destroyAndClear(m_screen_list);
 
     FbTk::STLUtil::destroyAndClear(m_atomhandler);
+
+    // the event stream atomhandler publishes through it until the end
+    m_remote.reset(0);
 }
 
 
 void Fluxbox::initScreen(BScreen *screen) {
 
+    const std::string sc_nr = FbTk::StringUtil::number2String(screen->screenNumber());
+
     // now we can create menus (which needs this screen to be in screen_list)
     screen->initMenus();
+    m_startup_profiler.mark("init menus " + sc_nr);
     screen->initWindows();
+    m_startup_profiler.mark("init windows " + sc_nr);
 
     // attach screen signals to this
     join(screen->workspaceAreaSig(),
@@ -529,6 +588,40 @@ void Fluxbox::eventLoop() {
     }
 }
 
+void Fluxbox::initRemoteControl() {
+    // prefer the per-user runtime directory, it is private and not on nfs
+    const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+    string dir = (runtime_dir && *runtime_dir) ? runtime_dir : m_RC_PATH;
+
+    // but the home directory might be shared with other machines
+    string host;
+    char hostname[256];
+    if (dir == m_RC_PATH && gethostname(hostname, sizeof(hostname)) == 0) {
+        hostname[sizeof(hostname) - 1] = '\0';
+        host = hostname;
+    }
+
+    m_remote.reset(new RemoteControl(
+        RemoteControl::socketPath(dir, DisplayString(display()), host)));
+    if (!m_remote->isListening())
+        return;
+
+    addAtomHandler(new EventStream(*m_remote));
+
+    // children find the socket through the environment, anybody else
+    // through the root window
+    const string &path = m_remote->path();
+    FbTk::App::setenv("FLUXBOX_SOCKET", path.c_str());
+
+    Atom socket_atom = XInternAtom(display(), "_FLUXBOX_SOCKET", False);
+    ScreenList::iterator it = m_screen_list.begin();
+    for (; it != m_screen_list.end(); ++it) {
+        (*it)->rootWindow().changeProperty(socket_atom, XA_STRING, 8,
+            PropModeReplace,
+            (unsigned char *)path.c_str(), path.size());
+    }
+}
+
 bool Fluxbox::validateWindow(Window window) const {
     XEvent event;
     if (XCheckTypedWindowEvent(display(), window, DestroyNotify, &event)) {
@@ -554,6 +647,7 @@ void Fluxbox::ungrab() {
 
 void Fluxbox::handleEvent(XEvent * const e) {
     _FB_USES_NLS;
+    FbTk::StatTimer stat_timer(m_event_stats[e->type < LASTEvent ? e->type : 0]);
     m_last_event = *e;
 
     // it is possible (e.g. during moving) for a window
@@ -1019,6 +1113,99 @@ void Fluxbox::attachSignals(FluxboxWindow &win) {
             CallMemFunWithRefArg<AtomHandler, FluxboxWindow&, void>(&AtomHandler::setupFrame, win));
 }
 
+void Fluxbox::prefetchProperties(FbTk::PropertyPrefetch &prefetch) {
+    STLUtil::forAll(m_atomhandler,
+            CallMemFunWithRefArg<AtomHandler, FbTk::PropertyPrefetch&, void>(&AtomHandler::prefetchProperties, prefetch));
+}
+
+void Fluxbox::dumpStats(std::ostream &os) {
+    m_startup_profiler.print(os);
+
+    if (!FbTk::Stats::isEnabled()) {
+        // whoever asks once will ask again, so start counting what
+        // costs something to count
+        os<<"timing statistics are collected from now on"<<endl;
+        FbTk::Stats::enable();
+        FbTk::RequestCounter::enable(display());
+    }
+
+    os<<"events:        count    total usec  max usec"<<endl;
+    for (int type = 0; type < LASTEvent; ++type) {
+        const FbTk::TimeStat &stat = m_event_stats[type];
+        if (stat.count() == 0)
+            continue;
+        os<<"  "<<setw(20)<<left<<eventName(type)<<right
+          <<setw(8)<<stat.count()<<setw(14)<<stat.totalUsec()
+          <<setw(10)<<stat.maxUsec()<<endl;
+    }
+
+    const FbTk::TimeStat &timeouts = FbTk::Timer::timeoutStat();
+    os<<"timers: "<<FbTk::Timer::numTimers()<<" running, "
+      <<timeouts.count()<<" timeouts in "<<timeouts.totalUsec()<<" usec"<<endl;
+
+    const FbTk::TimeStat &idle_jobs = FbTk::RenderQueue::jobStat();
+    os<<"idle rendering: "<<FbTk::RenderQueue::numPending()<<" queued, "
+      <<idle_jobs.count()<<" jobs in "<<idle_jobs.totalUsec()<<" usec"<<endl;
+
+    ScreenList::iterator it = m_screen_list.begin();
+    for (; it != m_screen_list.end(); ++it) {
+        FbTk::ImageControl &image_control = (*it)->imageControl();
+        const FbTk::TimeStat &renders = image_control.renderStat();
+        os<<"images of screen "<<(*it)->screenNumber()<<": "
+          <<image_control.cacheSize()<<" cached, "
+          <<image_control.cacheHits()<<" cache hits, "
+          <<image_control.cacheMisses()<<" misses, "
+          <<renders.count()<<" renders in "<<renders.totalUsec()<<" usec"<<endl;
+    }
+
+    os<<"x requests: "<<FbTk::RequestCounter::requests(display())<<endl;
+    os<<"x round trips: "<<FbTk::RequestCounter::roundTrips()<<endl;
+}
+
+void Fluxbox::dumpStatsJSON(std::ostream &os) {
+    FbTk::Stats::enable();
+    FbTk::RequestCounter::enable(display());
+
+    // one flat object, so the simplest parser will do
+    os<<"{\"startup_usec\":"<<m_startup_profiler.totalUsec()
+      <<",\"requests\":"<<FbTk::RequestCounter::requests(display())
+      <<",\"roundtrips\":"<<FbTk::RequestCounter::roundTrips();
+
+    for (int type = 0; type < LASTEvent; ++type) {
+        const FbTk::TimeStat &stat = m_event_stats[type];
+        if (stat.count() == 0)
+            continue;
+        os<<",\"event_"<<eventName(type)<<"_count\":"<<stat.count()
+          <<",\"event_"<<eventName(type)<<"_usec\":"<<stat.totalUsec()
+          <<",\"event_"<<eventName(type)<<"_max_usec\":"<<stat.maxUsec();
+    }
+
+    const FbTk::TimeStat &timeouts = FbTk::Timer::timeoutStat();
+    os<<",\"timers\":"<<FbTk::Timer::numTimers()
+      <<",\"timeout_count\":"<<timeouts.count()
+      <<",\"timeout_usec\":"<<timeouts.totalUsec();
+
+    const FbTk::TimeStat &idle_jobs = FbTk::RenderQueue::jobStat();
+    os<<",\"idle_render_queued\":"<<FbTk::RenderQueue::numPending()
+      <<",\"idle_render_count\":"<<idle_jobs.count()
+      <<",\"idle_render_usec\":"<<idle_jobs.totalUsec();
+
+    unsigned long hits = 0, misses = 0, renders = 0;
+    long long render_usec = 0;
+    ScreenList::iterator it = m_screen_list.begin();
+    for (; it != m_screen_list.end(); ++it) {
+        FbTk::ImageControl &image_control = (*it)->imageControl();
+        hits += image_control.cacheHits();
+        misses += image_control.cacheMisses();
+        renders += image_control.renderStat().count();
+        render_usec += image_control.renderStat().totalUsec();
+    }
+    os<<",\"image_cache_hits\":"<<hits
+      <<",\"image_cache_misses\":"<<misses
+      <<",\"render_count\":"<<renders
+      <<",\"render_usec\":"<<render_usec<<"}";
+}
+
 void Fluxbox::attachSignals(WinClient &winclient) {
     join(winclient.dieSig(), FbTk::MemFun(*this, &Fluxbox::clientDied));
     STLUtil::forAll(m_atomhandler,
@@ -1209,6 +1396,7 @@ void Fluxbox::load_rc() {
         m_rc_menufile.setDefaultValue();
 
     FbTk::Transparent::usePseudoTransparent(*m_rc_pseudotrans);
+    FbTk::MenuSearch::setMode(*m_rc_menusearch);
 
     if (!m_rc_slitlistfile->empty()) {
         *m_rc_slitlistfile = StringUtil::expandFilename(*m_rc_slitlistfile);
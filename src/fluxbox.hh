@@ -32,6 +32,8 @@
 #include "FbTk/Signal.hh"
 
 #include "AttentionNoticeHandler.hh"
+#include "StartupProfiler.hh"
+#include "FbTk/Stats.hh"
 
 #include <X11/Xresource.h>
 
@@ -59,6 +61,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -68,6 +71,11 @@ class WinClient;
 class Keys;
 class BScreen;
 class FbAtoms;
+class RemoteControl;
+
+namespace FbTk {
+class PropertyPrefetch;
+}
 
 /// main class for the window manager.
 /**
@@ -103,11 +111,21 @@ public:
     BScreen *searchScreen(Window w);
 
     unsigned int getDoubleClickInterval() const { return *m_rc_double_click_interval; }
+    /// minimum time in ms between two title updates of a client
+    int getTitleUpdateInterval() const { return *m_rc_title_update_interval; }
     Time getLastTime() const { return m_last_time; }
 
     AtomHandler *getAtomHandler(const std::string &name);
     void addAtomHandler(AtomHandler *atomh);
     void removeAtomHandler(AtomHandler *atomh);
+    /// adds the properties all atom handlers read from a new client
+    void prefetchProperties(FbTk::PropertyPrefetch &prefetch);
+
+    StartupProfiler &startupProfiler() { return m_startup_profiler; }
+    /// writes statistics for the dumpstats command
+    void dumpStats(std::ostream &os);
+    /// writes statistics as one json object, for the "stats" query
+    void dumpStatsJSON(std::ostream &os);
 
     /// obsolete
     enum TabsAttachArea{ATTACH_AREA_WINDOW= 0, ATTACH_AREA_TITLEBAR};
@@ -214,6 +232,8 @@ private:
 
     /// Called when the workspace area changed.
     void workspaceAreaChanged(BScreen &screen);
+    /// Creates the fluxbox-remote socket and tells the world where it is
+    void initRemoteControl();
     /// Called when a window (FluxboxWindow) dies
     void windowDied(Focusable &focusable);
     /// Called when a client (WinClient) dies
@@ -238,11 +258,12 @@ private:
     FbTk::Resource<bool> m_rc_pseudotrans;
     FbTk::Resource<int> m_rc_colors_per_channel,
         m_rc_double_click_interval,
+        m_rc_title_update_interval,
         m_rc_tabs_padding;
     FbTk::Resource<std::string> m_rc_stylefile,
         m_rc_styleoverlayfile,
         m_rc_menufile, m_rc_keyfile, m_rc_slitlistfile,
-        m_rc_appsfile;
+        m_rc_appsfile, m_rc_menusearch;
 
 
     FbTk::Resource<TabsAttachArea> m_rc_tabs_attach_area;
@@ -284,6 +305,7 @@ private:
     bool m_showing_dialog;
 
     std::auto_ptr<Keys> m_key;
+    std::auto_ptr<RemoteControl> m_remote; ///< socket for fluxbox-remote
 
     //default arguments for titlebar left and right
     static Fluxbox *s_singleton;
@@ -303,6 +325,9 @@ private:
     Atom m_kwm1_dockwindow, m_kwm2_dockwindow;
 
     AttentionNoticeHandler m_attention_handler;
+    StartupProfiler m_startup_profiler;
+    /// time spent in handleEvent per event type, extension events at 0
+    FbTk::TimeStat m_event_stats[LASTEvent];
 };
 
 
@@ -0,0 +1,77 @@
+#!/bin/sh
+# Runs fbbench against a fresh fluxbox on a private Xvfb server, so the
+# numbers don't depend on the desktop the benchmark was started from.
+# The results are printed as one json object per line, e.g.
+#   make -s bench >> bench.jsonl
+# keeps a history to compare commits with.
+#
+# usage: bench.sh fluxbox fbbench datadir [fbbench options]
+
+if [ $# -lt 3 ]; then
+    echo "usage: $0 fluxbox fbbench datadir [fbbench options]" >&2
+    exit 1
+fi
+
+fluxbox=$1
+fbbench=$2
+datadir=$3
+shift 3
+
+if ! command -v Xvfb > /dev/null 2>&1; then
+    echo "$0: Xvfb is needed to run the benchmarks" >&2
+    exit 1
+fi
+
+tmp=`mktemp -d "${TMPDIR:-/tmp}/fbbench.XXXXXX"` || exit 1
+xvfb_pid=
+fluxbox_pid=
+
+cleanup() {
+    [ -n "$fluxbox_pid" ] && kill $fluxbox_pid 2> /dev/null
+    [ -n "$xvfb_pid" ] && kill $xvfb_pid 2> /dev/null
+    wait 2> /dev/null
+    rm -rf "$tmp"
+}
+trap cleanup EXIT
+trap 'exit 1' INT TERM
+
+# let the server pick a free display and tell us which one
+Xvfb -displayfd 3 -screen 0 1280x1024x24 -nolisten tcp \
+    3> "$tmp/display" 2> "$tmp/Xvfb.log" &
+xvfb_pid=$!
+tries=0
+while [ ! -s "$tmp/display" ]; do
+    tries=`expr $tries + 1`
+    if [ $tries -gt 100 ] || ! kill -0 $xvfb_pid 2> /dev/null; then
+        echo "$0: Xvfb did not start:" >&2
+        cat "$tmp/Xvfb.log" >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+DISPLAY=:`cat "$tmp/display"`
+export DISPLAY
+
+# everything fluxbox reads or writes stays in the temporary directory
+HOME=$tmp
+XDG_RUNTIME_DIR=$tmp
+export HOME XDG_RUNTIME_DIR
+cat > "$tmp/init" <<EOT
+session.screen0.allowRemoteActions: true
+session.screen0.workspaces: 4
+session.styleFile: $datadir/styles/Emerge
+session.keyFile: $datadir/keys
+session.menuFile: $tmp/menu
+session.configVersion: 13
+EOT
+
+"$fluxbox" -rc "$tmp/init" 2> "$tmp/fluxbox.log" &
+fluxbox_pid=$!
+
+"$fbbench" "$@"
+status=$?
+if [ $status -ne 0 ]; then
+    echo "$0: fluxbox output:" >&2
+    cat "$tmp/fluxbox.log" >&2
+fi
+exit $status
@@ -0,0 +1,369 @@
+// fbbench.cc
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/*
+ * Runs scripted clients against a running fluxbox and measures what a
+ * user notices: how long a new window takes to show up, how long a
+ * workspace switch takes, how many move/resize steps per second fluxbox
+ * keeps up with and how long reloading the style takes.
+ *
+ * Every benchmark prints one line of json, with the number of X requests
+ * and round trips fluxbox made per operation, as reported by the "stats"
+ * query on the remote socket. "make bench" runs this against Xvfb.
+ * Needs session.screen0.allowRemoteActions: true
+ *
+ * usage: fbbench [-n count] [-r revision]
+ */
+
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+
+#include <sys/types.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+// how long to wait for fluxbox before giving up, in seconds
+const double TIMEOUT = 10;
+
+typedef map<string, double> Stats;
+
+double now() {
+    timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+string socketPath(Display *disp) {
+    Atom socket_atom = XInternAtom(disp, "_FLUXBOX_SOCKET", False);
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    unsigned char *data = 0;
+    string path;
+    if (XGetWindowProperty(disp, DefaultRootWindow(disp), socket_atom,
+                           0l, 1024l, False, XA_STRING, &type, &format,
+                           &nitems, &bytes_after, &data) == Success && data) {
+        path = (char *)data;
+        XFree(data);
+    }
+    return path;
+}
+
+int connectSocket(const string &path) {
+    sockaddr_un addr;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+    if (fd == -1 || connect(fd, (sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// fluxbox may still be starting up, so keep trying for a while
+int waitForFluxbox(Display *disp) {
+    double start = now();
+    while (now() - start < TIMEOUT) {
+        int fd = connectSocket(socketPath(disp));
+        if (fd != -1)
+            return fd;
+        usleep(50000);
+    }
+    return -1;
+}
+
+// sends @a command and @return the reply, without the trailing newline
+string sendCommand(int fd, const string &command) {
+    string data = command + "\n";
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t len = write(fd, data.data() + done, data.size() - done);
+        if (len <= 0)
+            return "";
+        done += len;
+    }
+
+    string reply;
+    char c;
+    while (read(fd, &c, 1) == 1 && c != '\n')
+        reply += c;
+    return reply;
+}
+
+// the stats are one flat json object of numbers
+Stats queryStats(int fd) {
+    Stats stats;
+    string reply = sendCommand(fd, "stats");
+    if (reply.compare(0, 3, "ok ") != 0)
+        return stats;
+
+    string::size_type pos = 0;
+    while ((pos = reply.find('"', pos)) != string::npos) {
+        string::size_type end = reply.find('"', pos + 1);
+        if (end == string::npos || end + 1 >= reply.size() ||
+            reply[end + 1] != ':')
+            break;
+        string key = reply.substr(pos + 1, end - pos - 1);
+        stats[key] = strtod(reply.c_str() + end + 2, 0);
+        pos = reply.find_first_of(",}", end);
+    }
+    return stats;
+}
+
+// waits for an event of @a type on @a win, for which @a atom matches
+// the property of PropertyNotify events
+bool waitForEvent(Display *disp, Window win, int type, XEvent &event,
+                  Atom atom = None) {
+    double start = now();
+    while (true) {
+        while (XCheckTypedWindowEvent(disp, win, type, &event)) {
+            if (type != PropertyNotify || event.xproperty.atom == atom)
+                return true;
+        }
+
+        double left = TIMEOUT - (now() - start);
+        if (left <= 0)
+            return false;
+
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        FD_SET(ConnectionNumber(disp), &rfds);
+        timeval tv;
+        tv.tv_sec = (long)left;
+        tv.tv_usec = (long)((left - tv.tv_sec) * 1000000);
+        select(ConnectionNumber(disp) + 1, &rfds, 0, 0, &tv);
+    }
+}
+
+void sendClientMessage(Display *disp, Window win, Atom type,
+                       long l0, long l1 = 0, long l2 = 0, long l3 = 0,
+                       long l4 = 0) {
+    XEvent ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.xclient.type = ClientMessage;
+    ev.xclient.window = win;
+    ev.xclient.message_type = type;
+    ev.xclient.format = 32;
+    ev.xclient.data.l[0] = l0;
+    ev.xclient.data.l[1] = l1;
+    ev.xclient.data.l[2] = l2;
+    ev.xclient.data.l[3] = l3;
+    ev.xclient.data.l[4] = l4;
+    XSendEvent(disp, DefaultRootWindow(disp), False,
+               SubstructureRedirectMask | SubstructureNotifyMask, &ev);
+    XFlush(disp);
+}
+
+// the stats also hold values that don't add up over time
+bool isCounter(const string &key) {
+    const string max_suffix = "_max_usec";
+    return key != "startup_usec" && key != "timers" &&
+        key != "idle_render_queued" &&
+        (key.size() < max_suffix.size() ||
+         key.compare(key.size() - max_suffix.size(), string::npos,
+                     max_suffix) != 0);
+}
+
+/// times of one benchmark and what fluxbox did meanwhile
+class Result {
+public:
+    Result(const string &name, int fd): m_name(name), m_fd(fd) {
+        m_before = queryStats(m_fd);
+    }
+
+    void add(double seconds) { m_samples.push_back(seconds * 1000.0); }
+
+    void print(const string &revision) {
+        Stats after = queryStats(m_fd);
+
+        ostringstream line;
+        line<<"{\"bench\":\""<<m_name<<"\"";
+        if (!revision.empty())
+            line<<",\"revision\":\""<<revision<<"\"";
+        line<<",\"count\":"<<m_samples.size();
+
+        if (!m_samples.empty()) {
+            vector<double> sorted(m_samples);
+            sort(sorted.begin(), sorted.end());
+            double total = 0;
+            for (size_t i = 0; i < sorted.size(); ++i)
+                total += sorted[i];
+            line<<",\"mean_ms\":"<<total / sorted.size()
+                <<",\"median_ms\":"<<sorted[sorted.size() / 2]
+                <<",\"min_ms\":"<<sorted.front()
+                <<",\"max_ms\":"<<sorted.back();
+            if (total > 0)
+                line<<",\"per_second\":"<<sorted.size() * 1000.0 / total;
+
+            // everything fluxbox counted meanwhile, per operation
+            Stats::const_iterator it = after.begin();
+            for (; it != after.end(); ++it) {
+                if (!isCounter(it->first))
+                    continue;
+                double delta = it->second - m_before[it->first];
+                if (delta != 0)
+                    line<<",\""<<it->first<<"_per_op\":"
+                        <<delta / sorted.size();
+            }
+        }
+        line<<"}";
+        cout<<line.str()<<endl;
+    }
+
+private:
+    string m_name;
+    int m_fd;
+    Stats m_before;
+    vector<double> m_samples;
+};
+
+void fail(const char *what) {
+    cout<<"{\"error\":\""<<what<<"\"}"<<endl;
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv) {
+    int count = 50;
+    string revision;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            count = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            revision = argv[++i];
+        else {
+            cerr<<"usage: "<<argv[0]<<" [-n count] [-r revision]"<<endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Display *disp = XOpenDisplay(0);
+    if (disp == 0) {
+        cerr<<"Can't open display"<<endl;
+        return EXIT_FAILURE;
+    }
+    Window root = DefaultRootWindow(disp);
+    XSelectInput(disp, root, PropertyChangeMask);
+
+    int fd = waitForFluxbox(disp);
+    if (fd == -1)
+        fail("can't connect to the fluxbox socket");
+
+    // the first query makes fluxbox count round trips, too
+    Stats startup = queryStats(fd);
+    cout<<"{\"bench\":\"startup\"";
+    if (!revision.empty())
+        cout<<",\"revision\":\""<<revision<<"\"";
+    cout<<",\"startup_ms\":"<<startup["startup_usec"] / 1000.0
+        <<",\"requests\":"<<startup["requests"]<<"}"<<endl;
+
+    XEvent event;
+
+    // time from XMapWindow until fluxbox decorated and mapped the window
+    vector<Window> windows;
+    Result map_result("map", fd);
+    for (int i = 0; i < count; ++i) {
+        Window win = XCreateSimpleWindow(disp, root, 10 * i, 10 * i, 200, 150,
+                                         0, 0, WhitePixel(disp, 0));
+        XSelectInput(disp, win, StructureNotifyMask);
+        XStoreName(disp, win, "fbbench");
+        XSync(disp, False);
+
+        double start = now();
+        XMapWindow(disp, win);
+        XFlush(disp);
+        if (!waitForEvent(disp, win, MapNotify, event))
+            fail("window was not mapped");
+        map_result.add(now() - start);
+        windows.push_back(win);
+    }
+    map_result.print(revision);
+
+    // switch away from the windows and back
+    Atom current_desktop = XInternAtom(disp, "_NET_CURRENT_DESKTOP", False);
+    XSync(disp, True);
+    Result workspace_result("workspace", fd);
+    for (int i = 0; i < count; ++i) {
+        double start = now();
+        sendClientMessage(disp, root, current_desktop, (i + 1) % 2);
+        if (!waitForEvent(disp, root, PropertyNotify, event, current_desktop))
+            fail("workspace did not change");
+        workspace_result.add(now() - start);
+    }
+    if (count % 2)
+        sendClientMessage(disp, root, current_desktop, 0);
+    workspace_result.print(revision);
+
+    // one step of an interactive move/resize, the size changes every
+    // step so every step ends with a real ConfigureNotify
+    Atom moveresize = XInternAtom(disp, "_NET_MOVERESIZE_WINDOW", False);
+    Window win = windows.front();
+    // forget the ConfigureNotify events from mapping the window
+    XSync(disp, True);
+    Result moveresize_result("moveresize", fd);
+    for (int i = 0; i < count * 4; ++i) {
+        double start = now();
+        sendClientMessage(disp, win, moveresize,
+                          NorthWestGravity | 0x0f00 | (2 << 12),
+                          i % 200, i % 100, 300 + i % 2, 200 + i % 2);
+        if (!waitForEvent(disp, win, ConfigureNotify, event))
+            fail("window was not configured");
+        moveresize_result.add(now() - start);
+    }
+    moveresize_result.print(revision);
+
+    // style and configuration reloads, they are slow, so do fewer
+    const char *reloads[] = { "reloadstyle", "reconfigure" };
+    for (size_t r = 0; r < sizeof(reloads) / sizeof(reloads[0]); ++r) {
+        Result reload_result(reloads[r], fd);
+        for (int i = 0; i < min(count, 10); ++i) {
+            double start = now();
+            if (sendCommand(fd, reloads[r]) != "ok")
+                fail("reload was refused, allowRemoteActions not set?");
+            reload_result.add(now() - start);
+        }
+        reload_result.print(revision);
+    }
+
+    close(fd);
+    XCloseDisplay(disp);
+    return EXIT_SUCCESS;
+}
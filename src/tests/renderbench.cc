@@ -0,0 +1,125 @@
+// renderbench.cc
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+/*
+ * Compares the two ways TextureRender gets its images to the X server:
+ * through shared memory (MIT-SHM) and through the socket. Renders a
+ * gradient a number of times in each size, without the image cache, and
+ * waits for the server to finish after each one.
+ *
+ * usage: renderbench [-display name] [-n count] [widthxheight ...]
+ */
+
+#include "FbTk/App.hh"
+#include "FbTk/ImageControl.hh"
+#include "FbTk/ShmImage.hh"
+#include "FbTk/Texture.hh"
+#include "FbTk/Color.hh"
+
+#include <sys/time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Size {
+    unsigned int width, height;
+};
+
+long usecSince(const timeval &start) {
+    timeval now;
+    gettimeofday(&now, 0);
+    return (now.tv_sec - start.tv_sec) * 1000000L + (now.tv_usec - start.tv_usec);
+}
+
+long bench(FbTk::ImageControl &ctrl, const FbTk::Texture &tex,
+           const Size &size, int count) {
+    Display *disp = FbTk::App::instance()->display();
+    timeval start;
+    gettimeofday(&start, 0);
+    for (int i = 0; i < count; ++i) {
+        Pixmap pm = ctrl.renderImage(size.width, size.height, tex,
+                                     FbTk::ROT0, false);
+        XSync(disp, False);
+        if (pm != None)
+            XFreePixmap(disp, pm);
+    }
+    return usecSince(start);
+}
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+    const char *display_name = 0;
+    int count = 20;
+    vector<Size> sizes;
+
+    for (int i = 1; i < argc; ++i) {
+        Size size;
+        if (strcmp(argv[i], "-display") == 0 && i + 1 < argc)
+            display_name = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            count = atoi(argv[++i]);
+        else if (sscanf(argv[i], "%ux%u", &size.width, &size.height) == 2)
+            sizes.push_back(size);
+        else {
+            fprintf(stderr, "usage: %s [-display name] [-n count] [widthxheight ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (sizes.empty()) {
+        Size defaults[] = { { 200, 20 }, { 300, 600 }, { 1280, 1024 }, { 1920, 1200 } };
+        sizes.assign(defaults, defaults + sizeof(defaults) / sizeof(defaults[0]));
+    }
+    if (count < 1)
+        count = 1;
+
+    FbTk::App app(display_name);
+    int screen = DefaultScreen(app.display());
+    FbTk::ImageControl ctrl(screen);
+
+    FbTk::Texture tex;
+    tex.setType(FbTk::Texture::GRADIENT | FbTk::Texture::DIAGONAL |
+                FbTk::Texture::RAISED);
+    tex.color().setFromString("rgb:20/40/80", screen);
+    tex.colorTo().setFromString("rgb:c0/d0/f0", screen);
+
+    printf("%-12s %12s %12s %8s\n", "size", "socket usec", "shm usec", "speedup");
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        FbTk::ShmImage::setEnabled(false);
+        long socket_usec = bench(ctrl, tex, sizes[i], count) / count;
+        FbTk::ShmImage::setEnabled(true);
+        long shm_usec = bench(ctrl, tex, sizes[i], count) / count;
+
+        char name[32];
+        sprintf(name, "%ux%u", sizes[i].width, sizes[i].height);
+        printf("%-12s %12ld %12ld %7.2fx\n", name, socket_usec, shm_usec,
+               shm_usec > 0 ? double(socket_usec) / shm_usec : 0.0);
+    }
+
+    return 0;
+}
@@ -1,226 +1,219 @@
 // testLayers.cc a test app for Layers
 // Copyright (c) 2003 - 2006 Henrik Kinnunen (fluxgen at fluxbox dot org)
 
-
-#include "App.hh"
-#include "FbWindow.hh"
-#include "Color.hh"
-#include "EventManager.hh"
-#include <iostream>
-#include "Layer.hh"
-#include "LayerItem.hh"
-#include "MultLayers.hh"
+// Checks that the windows of a MultLayers end up stacked in the order of
+// its layers and items, and that the StackingOrder it restacks with
+// doesn't move more windows than it has to. The StackingOrder part runs
+// without an X server; the MultLayers part runs if there is one.
+
+#include "FbTk/App.hh"
+#include "FbTk/FbWindow.hh"
+#include "FbTk/Layer.hh"
+#include "FbTk/LayerItem.hh"
+#include "FbTk/MultLayers.hh"
+#include "FbTk/StackingOrder.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <vector>
 
 using namespace FbTk;
-using namespace std;
-int main() {
-    FbTk::App app;
-    int mask = ButtonPressMask;
-    FbWindow win_red(0, 0, 0, 60, 60, mask, true);
-    FbWindow win_redB(0, 0, 0, 60, 60, mask, true);
-    FbWindow win_blue(0, 30, 0, 60, 60, mask, true);
-    FbWindow win_green(0, 60, 0, 60, 60, mask, true);
-    FbWindow win_red2(0, 0, 0, 60, 60, mask, true);
-    FbWindow win_blue2(0, 30, 0, 60, 60, mask, true);
-    FbWindow win_green2(0, 60, 0, 60, 60, mask, true);
-    FbWindow win_red3(0, 0, 0, 60, 60, mask, true);
-    FbWindow win_blue3(0, 30, 0, 60, 60, mask, true);
-    FbWindow win_green3(0, 60, 0, 60, 60, mask, true);
-    Color red("red", 0);
-    Color blue("blue", 0);
-    Color green("green", 0);
-    Color red2("magenta", 0);
-    Color blue2("cyan", 0);
-    Color green2("yellow", 0);
-    Color red3("pink", 0);
-    Color blue3("navy", 0);
-    Color green3("brown", 0);
-    win_red.setBackgroundColor(red);
-    win_red.clear();
-    win_redB.setBackgroundColor(red);
-    win_redB.clear();
-    win_blue.setBackgroundColor(blue);
-    win_blue.clear();
-    win_green.setBackgroundColor(green);
-    win_green.clear();
-
-    win_red2.setBackgroundColor(red2);
-    win_red2.clear();
-    win_blue2.setBackgroundColor(blue2);
-    win_blue2.clear();
-    win_green2.setBackgroundColor(green2);
-    win_green2.clear();
-
-    win_red3.setBackgroundColor(red3);
-    win_red3.clear();
-    win_blue3.setBackgroundColor(blue3);
-    win_blue3.clear();
-    win_green3.setBackgroundColor(green3);
-    win_green3.clear();
-
-    win_red.show();
-    win_red.move(10, 10);
-    win_redB.show();
-    win_redB.move(30, 30);
-    win_blue.show();
-    win_blue.move(40, 40);    
-    win_green.show();
-    win_green.move(50, 20);
-    
-    win_red2.show();
-    win_red2.move(15, 15);
-    win_blue2.show();
-    win_blue2.move(45, 45);    
-    win_green2.show();
-    win_green2.move(45, 15);
-
-    /*
-    win_red3.show();
-    win_red3.move(5, 5);
-    win_blue3.show();
-    win_blue3.move(35, 35);    
-    win_green3.show();
-    win_green3.move(45, 5);
-    */
-
-    EventManager &evm = *EventManager::instance();
-    Display *disp = app.display();
-    XEvent event;
-    MultLayers *ml = new MultLayers(3);
-    LayerItem *item_red = new XLayerItem(win_red.window());
-    item_red->addWindow(win_redB.window());
-    LayerItem *item_green = new LayerItem(win_green.window());
-    LayerItem *item_blue = new LayerItem(win_blue.window());
-
-    ml->addToTop(*item_blue, 0);
-    ml->addToTop(*item_green, 0);
-    ml->addToTop(*item_red, 0);
-
-    LayerItem *item_red2 = new LayerItem(win_red2.window());
-    LayerItem *item_green2 = new LayerItem(win_green2.window());
-    LayerItem *item_blue2 = new LayerItem(win_blue2.window());
-
-    ml->addToTop(*item_blue2, 1);
-    ml->addToTop(*item_green2, 1);
-    ml->addToTop(*item_red2, 1);
-
-    LayerItem *item_red3 = new LayerItem(win_red3.window());
-    LayerItem *item_green3 = new LayerItem(win_green3.window());
-    LayerItem *item_blue3 = new LayerItem(win_blue3.window());
-
-    ml->addToTop(*item_blue3, 2);
-    ml->addToTop(*item_green3, 2);
-    ml->addToTop(*item_red3, 2);
-
-    //item_blue.setLayer(*layer);
-    //item_green.setLayer(*layer);
-    //item_red.setLayer(*layer);
-    cerr<<"red: "<<hex<<win_red.window()<<endl;
-    cerr<<"blue: "<<hex<<win_blue.window()<<endl;
-    cerr<<"green: "<<hex<<win_green.window()<<endl;
-    cerr<<"Left click on color to raise one step"<<endl;
-    cerr<<"Right click on color to raise to next level up"<<endl;
-    cerr<<"Middle click on color to lower to next level down"<<endl;
-    XFlush(disp);
-    //layer.restack();
-    while (1) {
-        while (XNextEvent(disp, &event))
-            continue;
-        if (event.xbutton.button == 1) {
-            if (event.xany.window == win_red.window() || event.xany.window == win_redB.window()) {
-                item_red->raise();
-                cerr<<"Raise red"<<endl;
-            } else if (event.xany.window == win_blue.window()) {
-                item_blue->raise();
-                cerr<<"Raise blue"<<endl;
-            } else if (event.xany.window == win_green.window()) {
-                item_green->raise();
-                cerr<<"Raise green"<<endl;
-            } else if (event.xany.window == win_red2.window()) {
-                item_red2->raise();
-                cerr<<"Raise red2"<<endl;
-            } else if (event.xany.window == win_blue2.window()) {
-                item_blue2->raise();
-                cerr<<"Raise blue2"<<endl;
-            } else if (event.xany.window == win_green2.window()) {
-                item_green2->raise();
-                cerr<<"Raise green2"<<endl;
-            } else if (event.xany.window == win_red3.window()) {
-                item_red3->raise();
-                cerr<<"Raise red3"<<endl;
-            } else if (event.xany.window == win_blue3.window()) {
-                item_blue3->raise();
-                cerr<<"Raise blue3"<<endl;
-            } else if (event.xany.window == win_green3.window()) {
-                item_green3->raise();
-                cerr<<"Raise green3"<<endl;
-            } else {
-                cerr<<"Unknown window"<<endl;
-            }
-
-        } else if (event.xbutton.button == 3) {
-            if (event.xany.window == win_red.window() || event.xany.window == win_redB.window()) {
-                ml->raise(*item_red);
-            } else if (event.xany.window == win_blue.window()) {
-                ml->raise(*item_blue);
-            } else if (event.xany.window == win_green.window()) {
-                ml->raise(*item_green);
-            } else if (event.xany.window == win_red2.window()) {
-                ml->raise(*item_red2);
-            } else if (event.xany.window == win_blue2.window()) {
-                ml->raise(*item_blue2);
-            } else if (event.xany.window == win_green2.window()) {
-                ml->raise(*item_green2);
-            } else if (event.xany.window == win_red3.window()) {
-                ml->raise(*item_red3);
-            } else if (event.xany.window == win_blue3.window()) {
-                ml->raise(*item_blue3);
-            } else if (event.xany.window == win_green3.window()) {
-                ml->raise(*item_green3);
-            } else {
-                cerr<<"Unknown window"<<endl;
-            }
-
-        } else if (event.xbutton.button == 2) {
-            if (event.xany.window == win_red.window() || event.xany.window == win_redB.window()) {
-                ml->lower(*item_red);
-            } else if (event.xany.window == win_blue.window()) {
-                ml->lower(*item_blue);
-            } else if (event.xany.window == win_green.window()) {
-                ml->lower(*item_green);
-            } else if (event.xany.window == win_red2.window()) {
-                ml->lower(*item_red2);
-            } else if (event.xany.window == win_blue2.window()) {
-                ml->lower(*item_blue2);
-            } else if (event.xany.window == win_green2.window()) {
-                ml->lower(*item_green2);
-            } else if (event.xany.window == win_red3.window()) {
-                ml->lower(*item_red3);
-            } else if (event.xany.window == win_blue3.window()) {
-                ml->lower(*item_blue3);
-            } else if (event.xany.window == win_green3.window()) {
-                ml->lower(*item_green3);
-            } else {
-                cerr<<"Unknown window"<<endl;
-            }
-
-        } else {
-            cerr<<"Button: "<<event.xbutton.button<<endl;
-            if (event.xany.window == win_red.window() || event.xany.window == win_redB.window()) {
-                item_red->raise();
-                cerr<<"Raise red"<<endl;
-            } else if (event.xany.window == win_blue.window()) {
-                item_blue->raise();
-                cerr<<"Raise blue"<<endl;
-            } else if (event.xany.window == win_green.window()) {
-                item_green->raise();
-                cerr<<"Raise green"<<endl;
-            } else {
-                cerr<<"Unknown window"<<endl;
-            }
-            
+using std::vector;
+
+namespace {
+
+int s_failed = 0;
+
+void check(bool ok, const char *what) {
+    if (!ok) {
+        printf("FAILED: %s\n", what);
+        ++s_failed;
+    }
+}
+
+// the relative order of 'windows' in 'stack'
+vector<Window> relativeOrder(const vector<Window> &stack,
+                             const vector<Window> &windows) {
+    vector<Window> order;
+    for (size_t i = 0; i < stack.size(); ++i) {
+        if (std::find(windows.begin(), windows.end(), stack[i]) != windows.end())
+            order.push_back(stack[i]);
+    }
+    return order;
+}
+
+// does to a stack (top to bottom) what the server would do
+void applyMoves(vector<Window> &stack, const StackingOrder::Moves &moves) {
+    for (size_t i = 0; i < moves.size(); ++i) {
+        stack.erase(std::find(stack.begin(), stack.end(), moves[i].window));
+        vector<Window>::iterator sibling =
+            std::find(stack.begin(), stack.end(), moves[i].sibling);
+        if (moves[i].stack_mode == Below)
+            ++sibling;
+        stack.insert(sibling, moves[i].window);
+    }
+}
+
+size_t countMoves(StackingOrder &order, const vector<Window> &windows) {
+    StackingOrder::Moves moves;
+    order.update(windows, moves);
+    return moves.size();
+}
+
+void testStackingOrder() {
+    printf("testing StackingOrder\n");
+
+    vector<Window> windows;
+    for (Window w = 1; w <= 20; ++w)
+        windows.push_back(w);
+
+    StackingOrder order;
+    check(countMoves(order, windows) == windows.size() - 1,
+          "first restack moves all but the top window");
+    check(countMoves(order, windows) == 0, "same order moves nothing");
+
+    // raise
+    vector<Window> raised(windows);
+    std::rotate(raised.begin(), raised.begin() + 12, raised.begin() + 13);
+    check(countMoves(order, raised) == 1, "raise is one move");
+
+    // lower
+    vector<Window> lowered(raised);
+    std::rotate(lowered.begin(), lowered.begin() + 1, lowered.end());
+    check(countMoves(order, lowered) == 1, "lower is one move");
+
+    // a new window
+    lowered.insert(lowered.begin() + 5, 100);
+    check(countMoves(order, lowered) == 1, "new window is one move");
+
+    // random orders, with windows coming and going and windows
+    // in between that we don't stack
+    srand(42);
+    vector<Window> stack;
+    for (Window w = 1000; w < 1010; ++w)
+        stack.push_back(w);
+
+    order.clear();
+    for (int round = 0; round < 500; ++round) {
+        vector<Window> wanted;
+        for (Window w = 1; w <= 30; ++w) {
+            if (rand() % 4 != 0)
+                wanted.push_back(w);
+        }
+        for (size_t i = wanted.size(); i > 1; --i)
+            std::swap(wanted[i - 1], wanted[rand() % i]);
+        // partially sorted, like real restacks
+        if (round % 2)
+            std::sort(wanted.begin(), wanted.begin() + wanted.size() / 2);
+
+        // new windows start on top
+        for (size_t i = 0; i < wanted.size(); ++i) {
+            if (std::find(stack.begin(), stack.end(), wanted[i]) == stack.end())
+                stack.insert(stack.begin(), wanted[i]);
+        }
+
+        StackingOrder::Moves moves;
+        order.update(wanted, moves);
+        applyMoves(stack, moves);
+        if (relativeOrder(stack, wanted) != wanted) {
+            check(false, "random restack");
+            break;
         }
+    }
+}
+
+vector<Window> queryStack(Display *disp, const vector<Window> &windows) {
+    Window root, parent, *children = 0;
+    unsigned int num = 0;
+    XQueryTree(disp, DefaultRootWindow(disp), &root, &parent, &children, &num);
+    // bottom to top
+    vector<Window> stack(children, children + num);
+    std::reverse(stack.begin(), stack.end());
+    if (children)
+        XFree(children);
+    return relativeOrder(stack, windows);
+}
+
+void testMultLayers() {
+    printf("testing MultLayers\n");
+
+    Display *disp = App::instance()->display();
+    const int num_layers = 3, num_items = 12;
+
+    MultLayers layers(num_layers);
+    vector<FbWindow *> fbwins;
+    vector<LayerItem *> items;
+    vector<Window> windows;
+    for (int i = 0; i < num_items; ++i) {
+        fbwins.push_back(new FbWindow(DefaultScreen(disp), 0, 0, 10, 10, 0));
+        windows.push_back(fbwins.back()->window());
+        items.push_back(new LayerItem(*fbwins.back(),
+                                      *layers.getLayer(i % num_layers)));
+        if (i % 5 == 0) {
+            // an item with two windows
+            fbwins.push_back(new FbWindow(DefaultScreen(disp), 0, 0, 10, 10, 0));
+            windows.push_back(fbwins.back()->window());
+            items.back()->addWindow(*fbwins.back());
+        }
+    }
+
+    srand(7);
+    for (int round = 0; round < 300; ++round) {
+        LayerItem &item = *items[rand() % items.size()];
+        switch (rand() % 5) {
+        case 0:
+            item.raise();
+            break;
+        case 1:
+            item.lower();
+            break;
+        case 2:
+            item.tempRaise();
+            break;
+        case 3:
+            item.moveToLayer(rand() % num_layers);
+            break;
+        case 4:
+            layers.lock();
+            item.raise();
+            items[rand() % items.size()]->lower();
+            layers.unlock();
+            break;
+        }
+
+        vector<Window> expected;
+        for (int l = 0; l < num_layers; ++l)
+            layers.getLayer(l)->extractWindows(expected);
+
+        XSync(disp, False);
+        if (queryStack(disp, windows) != expected) {
+            check(false, "stacking order of the layers");
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < items.size(); ++i)
+        delete items[i];
+    for (size_t i = 0; i < fbwins.size(); ++i)
+        delete fbwins[i];
+}
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+    testStackingOrder();
 
+    try {
+        App app(argc > 1 ? argv[1] : 0);
+        testMultLayers();
+    } catch (const std::string &error) {
+        printf("skipping the MultLayers test: %s\n", error.c_str());
     }
 
+    if (s_failed == 0)
+        printf("all tests passed\n");
+    return s_failed == 0 ? 0 : 1;
 }
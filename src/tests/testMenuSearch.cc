@@ -0,0 +1,118 @@
+#include "FbTk/MenuSearch.hh"
+#include "FbTk/MenuItem.hh"
+#include "FbTk/StringUtil.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+
+using FbTk::MenuSearch;
+using FbTk::MenuItem;
+
+namespace {
+
+MenuSearch::Items s_items;
+int s_failed = 0;
+
+void addItem(const char *label) {
+    MenuItem *item = new MenuItem(FbTk::BiDiString(label));
+    item->setIndex(s_items.size());
+    s_items.push_back(item);
+}
+
+void search(MenuSearch &search, const char *str) {
+    search.clear();
+    for (; *str; ++str)
+        search.add(*str);
+}
+
+void check(const char *mode, const char *str, size_t expected) {
+    MenuSearch::setMode(mode);
+    MenuSearch s;
+    s.init(s_items);
+    search(s, str);
+
+    size_t found = s.size() ? s.matched().size() : 0;
+    printf("  %-9s \"%s\": %u matches, %s\n", mode, str,
+           (unsigned int)found, found == expected ? "ok" : "failed");
+    if (found != expected)
+        s_failed++;
+}
+
+long usecSince(const timeval &start) {
+    timeval now;
+    gettimeofday(&now, 0);
+    return (now.tv_sec - start.tv_sec) * 1000000L +
+           (now.tv_usec - start.tv_usec);
+}
+
+} // end anonymous namespace
+
+int main(int argc, char **argv) {
+
+    printf("testing MenuSearch\n");
+
+    addItem("Terminal");
+    addItem("Web Browser");
+    addItem("xterm");
+    addItem("Text Editor");
+    addItem("Mail");
+
+    check("itemstart", "te", 2);
+    check("itemstart", "TER", 1);
+    // characters that would leave nothing are skipped
+    check("itemstart", "erm", 1);
+    check("somewhere", "erm", 2);
+    check("somewhere", "er", 3);
+    check("fuzzy", "tedt", 1);
+    check("fuzzy", "wbr", 1);
+    check("nowhere", "t", 0);
+
+    MenuSearch::setMode("itemstart");
+    MenuSearch s;
+    s.init(s_items);
+    search(s, "t");
+    s.seek();
+    s.backspace();
+    printf("  backspace after seek: \"t\" has %u matches, %s\n",
+           (unsigned int)s.matched().size(),
+           s.matched().size() == 2 ? "ok" : "failed");
+
+    size_t start = 0, length = 0;
+    MenuSearch::setMode("somewhere");
+    search(s, "rm");
+    bool underlined = s.underline(*s_items[2], start, length);
+    printf("  underline \"rm\" in xterm: %u+%u, %s\n",
+           (unsigned int)start, (unsigned int)length,
+           (underlined && start == 3 && length == 2) ? "ok" : "failed");
+
+    // a menu like a big window list or generated application menu
+    const size_t big = argc > 1 ? atoi(argv[1]) : 10000;
+    for (size_t i = s_items.size(); i < big; ++i) {
+        std::string label = "Application " + FbTk::StringUtil::number2String(i);
+        addItem(label.c_str());
+    }
+
+    const char *modes[] = { "itemstart", "somewhere", "fuzzy" };
+    for (size_t m = 0; m < sizeof(modes)/sizeof(modes[0]); ++m) {
+        MenuSearch::setMode(modes[m]);
+        MenuSearch big_search;
+        big_search.init(s_items);
+        timeval start_time;
+        gettimeofday(&start_time, 0);
+        search(big_search, "app");
+        long first = usecSince(start_time);
+        gettimeofday(&start_time, 0);
+        search(big_search, "appl 99");
+        long second = usecSince(start_time);
+        printf("  %u items, %-9s: %ld usec to index and search, %ld usec with index\n",
+               (unsigned int)s_items.size(), modes[m], first, second);
+    }
+
+    for (size_t i = 0; i < s_items.size(); ++i)
+        delete s_items[i];
+
+    printf("done.\n");
+
+    return s_failed ? 1 : 0;
+}
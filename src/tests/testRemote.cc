@@ -0,0 +1,175 @@
+// testRemote.cc
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+/*
+ * Measures how many commands per second a running fluxbox accepts,
+ * through the _FLUXBOX_ACTION property and through the remote socket.
+ * Needs session.screen0.allowRemoteActions: true
+ *
+ * usage: testRemote [-n count] [command]
+ */
+
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <iostream>
+using namespace std;
+
+double now() {
+    timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+void report(const char *name, int count, double seconds) {
+    cout<<name<<": "<<count<<" commands in "<<seconds<<" s, "
+        <<(seconds > 0 ? count / seconds : 0)<<" commands/s"<<endl;
+}
+
+int connectSocket(Display *disp) {
+    string path;
+    if (getenv("FLUXBOX_SOCKET"))
+        path = getenv("FLUXBOX_SOCKET");
+    else {
+        Atom socket_atom = XInternAtom(disp, "_FLUXBOX_SOCKET", False);
+        Atom type;
+        int format;
+        unsigned long nitems, bytes_after;
+        unsigned char *data = 0;
+        if (XGetWindowProperty(disp, DefaultRootWindow(disp), socket_atom,
+                               0l, 1024l, False, XA_STRING, &type, &format,
+                               &nitems, &bytes_after, &data) == Success && data) {
+            path = (char *)data;
+            XFree(data);
+        }
+    }
+
+    sockaddr_un addr;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path.c_str());
+    if (fd == -1 || connect(fd, (sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool writeAll(int fd, const string &data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t len = write(fd, data.data() + done, data.size() - done);
+        if (len <= 0)
+            return false;
+        done += len;
+    }
+    return true;
+}
+
+// read until we have seen @a count replies
+bool readReplies(int fd, int count) {
+    char buf[4096];
+    while (count > 0) {
+        ssize_t len = read(fd, buf, sizeof(buf));
+        if (len <= 0)
+            return false;
+        for (ssize_t i = 0; i < len; ++i) {
+            if (buf[i] == '\n')
+                count--;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int count = 1000;
+    string command = "hidemenus";
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            count = atoi(argv[++i]);
+        else
+            command = argv[i];
+    }
+
+    Display *disp = XOpenDisplay(0);
+    if (disp == 0) {
+        cerr<<"Can't open display"<<endl;
+        return EXIT_FAILURE;
+    }
+
+    // old way, one property change and one round trip per command
+    Atom fbcmd_atom = XInternAtom(disp, "_FLUXBOX_ACTION", False);
+    double start = now();
+    for (int i = 0; i < count; ++i) {
+        XChangeProperty(disp, DefaultRootWindow(disp), fbcmd_atom,
+                        XA_STRING, 8, PropModeReplace,
+                        (unsigned char *)command.c_str(), command.size());
+        XSync(disp, False);
+    }
+    report("property", count, now() - start);
+
+    int fd = connectSocket(disp);
+    if (fd == -1) {
+        cerr<<"Can't connect to the fluxbox socket"<<endl;
+        XCloseDisplay(disp);
+        return EXIT_FAILURE;
+    }
+
+    // one command at a time, waiting for each reply
+    start = now();
+    for (int i = 0; i < count; ++i) {
+        if (!writeAll(fd, command + "\n") || !readReplies(fd, 1)) {
+            cerr<<"Lost connection"<<endl;
+            return EXIT_FAILURE;
+        }
+    }
+    report("socket", count, now() - start);
+
+    // everything in one write, then wait for all replies
+    string batch;
+    for (int i = 0; i < count; ++i)
+        batch += command + "\n";
+    start = now();
+    if (!writeAll(fd, batch) || !readReplies(fd, count)) {
+        cerr<<"Lost connection"<<endl;
+        return EXIT_FAILURE;
+    }
+    report("socket batch", count, now() - start);
+
+    close(fd);
+    XCloseDisplay(disp);
+    return EXIT_SUCCESS;
+}
@@ -5,6 +5,7 @@ using namespace std;
 #include "../FbTk/MemFun.hh"
 
 #include <string>
+#include <sys/time.h>
 
 
 
@@ -61,6 +62,72 @@ struct FunctionClass {
 
 };
 
+struct Counter {
+    Counter(): count(0) { }
+    void add(int value) { count += value; }
+    void increment() { ++count; }
+    long count;
+};
+
+double now() {
+    timeval tv;
+    gettimeofday(&tv, 0);
+    return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+void benchmarkEmit(int slots, int emits) {
+    using namespace FbTk;
+    Counter counter;
+    Signal<int> sig;
+    for (int i = 0; i < slots; ++i)
+        sig.connect(MemFun(counter, &Counter::add));
+
+    double start = now();
+    for (int i = 0; i < emits; ++i)
+        sig.emit(1);
+    double time = now() - start;
+
+    cout << "emit, " << slots << " slots: " << emits << " emits in "
+         << time << " s (" << (time * 1e9 / emits) << " ns/emit)"
+         << (counter.count == long(slots) * emits ? "" : " WRONG COUNT") << endl;
+}
+
+// the typical window life cycle: a few trackers joining and leaving signals
+void benchmarkTracker(int rounds) {
+    using namespace FbTk;
+    Counter counter;
+    Signal<> title, state, focus, die;
+
+    double start = now();
+    for (int i = 0; i < rounds; ++i) {
+        SignalTracker tracker;
+        tracker.join(title, MemFun(counter, &Counter::increment));
+        tracker.join(state, MemFun(counter, &Counter::increment));
+        tracker.join(focus, MemFun(counter, &Counter::increment));
+        tracker.join(die, MemFun(counter, &Counter::increment));
+        title.emit();
+        tracker.leave(state);
+    }
+    double time = now() - start;
+
+    cout << "tracker join/leave: " << rounds << " rounds in " << time
+         << " s (" << (time * 1e9 / rounds) << " ns/round)" << endl;
+}
+
+struct SelfDisconnect {
+    SelfDisconnect(FbTk::Signal<> &sig): m_sig(sig), calls(0) { }
+    void operator()() {
+        ++calls;
+        m_tracker.leave(m_sig);
+    }
+    void join() { m_tracker.join(m_sig, FbTk::MemFun(*this, &SelfDisconnect::call)); }
+    void call() { (*this)(); }
+
+    FbTk::Signal<> &m_sig;
+    FbTk::SignalTracker m_tracker;
+    int calls;
+};
+
 struct Printer {
     void printInt(int value) {
         cout << "Int:" << value << endl;
@@ -169,4 +236,25 @@ int main() {
         source2.connect(MemFunSelectArg1(printer, &Printer::printInt));
         source2.emit("world", 37);
     }
+
+    // disconnecting during emit must neither skip nor repeat other slots
+    {
+        cout << "----------- Testing disconnect during emit." << endl;
+        Signal<> sig;
+        Counter counter;
+        SelfDisconnect first(sig), second(sig);
+        first.join();
+        sig.connect(MemFun(counter, &Counter::increment));
+        second.join();
+        sig.emit();
+        sig.emit();
+        cout << "calls: " << first.calls << ", " << counter.count << ", "
+             << second.calls << " (expected 1, 2, 1)" << endl;
+    }
+
+    cout << "----------- Benchmarks." << endl;
+    benchmarkEmit(1, 10000000);
+    benchmarkEmit(4, 10000000);
+    benchmarkEmit(16, 1000000);
+    benchmarkTracker(1000000);
 }
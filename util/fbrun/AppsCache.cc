@@ -0,0 +1,211 @@
+// AppsCache.cc for fbrun
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "AppsCache.hh"
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+using std::string;
+
+namespace {
+
+// one stat instead of FileUtil::isRegularFile() and isExecutable()
+bool isExecutableFile(const string &filename) {
+    struct stat buf;
+    if (stat(filename.c_str(), &buf) != 0 || !S_ISREG(buf.st_mode))
+        return false;
+    return (buf.st_mode & (S_IXUSR | S_IXGRP | S_IXOTH)) != 0;
+}
+
+} // end anonymous namespace
+
+AppsCache::AppsCache(const string &path, const string &cache_file):
+    m_cache_file(cache_file),
+    m_next_dir(0),
+    m_reading(false),
+    m_changed(false),
+    m_sorted(false) {
+
+    std::set<string> seen;
+    string::size_type start = 0;
+    while (start <= path.size()) {
+        string::size_type end = path.find(':', start);
+        if (end == string::npos)
+            end = path.size();
+        string dir = path.substr(start, end - start);
+        if (!dir.empty() && seen.insert(dir).second)
+            m_dirs.push_back(dir);
+        start = end + 1;
+    }
+
+    load();
+}
+
+AppsCache::~AppsCache() {
+    // fbrun is often done before the scan is, without this a slow
+    // $PATH would be read from scratch every single time
+    if (m_sorted || !m_changed || m_scanned.empty())
+        return;
+
+    // the directories not reached yet keep their old entries
+    DirMap dirs(m_scanned);
+    for (size_t i = m_next_dir; i < m_dirs.size(); ++i) {
+        DirMap::const_iterator it = m_cached.find(m_dirs[i]);
+        if (it != m_cached.end())
+            dirs.insert(*it);
+    }
+    save(dirs);
+}
+
+bool AppsCache::scanSome() {
+    if (!m_reading && m_next_dir < m_dirs.size()) {
+        // a directory that didn't change comes from the cache
+        startDirectory(m_dirs[m_next_dir++]);
+    } else {
+        // every entry costs a stat, which can be slow on network mounts
+        for (int i = 0; i < 32 && m_reading; ++i) {
+            struct dirent *ent = m_dir.read();
+            if (ent == 0) {
+                finishDirectory();
+                break;
+            }
+            string name = ent->d_name;
+            if (name == "." || name == ".." || name.find('\n') != string::npos)
+                continue;
+            if (isExecutableFile(m_dir.name() + "/" + name))
+                m_current.apps.push_back(name);
+        }
+    }
+
+    if (!done())
+        return true;
+    if (!m_sorted)
+        finishScan();
+    return false;
+}
+
+const AppsCache::Apps &AppsCache::apps() {
+    while (scanSome())
+        continue;
+    return m_apps;
+}
+
+void AppsCache::startDirectory(const string &dir) {
+    struct stat buf;
+    if (stat(dir.c_str(), &buf) != 0 || !S_ISDIR(buf.st_mode))
+        return;
+
+    DirMap::const_iterator it = m_cached.find(dir);
+    if (it != m_cached.end() && it->second.mtime == buf.st_mtime) {
+        m_scanned[dir] = it->second;
+        return;
+    }
+
+    if (!m_dir.open(dir.c_str()))
+        return;
+
+    m_changed = true;
+    m_reading = true;
+    m_current = DirEntry();
+    // the directory might still change within this second,
+    // don't trust a timestamp that recent next time
+    if (buf.st_mtime < time(0))
+        m_current.mtime = buf.st_mtime;
+}
+
+void AppsCache::finishDirectory() {
+    m_scanned[m_dir.name()] = m_current;
+    m_current = DirEntry();
+    m_dir.close();
+    m_reading = false;
+}
+
+void AppsCache::finishScan() {
+    m_apps.clear();
+    DirMap::const_iterator it = m_scanned.begin();
+    for (; it != m_scanned.end(); ++it)
+        m_apps.insert(m_apps.end(), it->second.apps.begin(), it->second.apps.end());
+    std::sort(m_apps.begin(), m_apps.end());
+    m_apps.erase(std::unique(m_apps.begin(), m_apps.end()), m_apps.end());
+    m_sorted = true;
+
+    // directories that left $PATH are dropped from the cache
+    if (m_changed || m_scanned.size() != m_cached.size())
+        save(m_scanned);
+}
+
+// The cache file has a line with the modification time and name of
+// each directory, followed by its executables, one per line and each
+// starting with a tab.
+void AppsCache::load() {
+    if (m_cache_file.empty())
+        return;
+
+    std::ifstream infile(m_cache_file.c_str());
+    DirEntry *entry = 0;
+    string line;
+    while (getline(infile, line)) {
+        if (!line.empty() && line[0] == '\t') {
+            if (entry)
+                entry->apps.push_back(line.substr(1));
+            continue;
+        }
+
+        char *end = 0;
+        long mtime = strtol(line.c_str(), &end, 10);
+        if (end != line.c_str() && *end == ' ' && end[1] != '\0') {
+            entry = &m_cached[end + 1];
+            entry->mtime = mtime;
+        } else
+            entry = 0;
+    }
+}
+
+void AppsCache::save(const DirMap &dirs) const {
+    if (m_cache_file.empty())
+        return;
+
+    // write a new file and move it over the old one, so another
+    // fbrun never reads half a cache
+    string tmp_file = m_cache_file + ".tmp";
+    std::ofstream outfile(tmp_file.c_str());
+    if (!outfile)
+        return;
+
+    DirMap::const_iterator it = dirs.begin();
+    for (; it != dirs.end(); ++it) {
+        outfile << it->second.mtime << ' ' << it->first << '\n';
+        Apps::const_iterator app = it->second.apps.begin();
+        for (; app != it->second.apps.end(); ++app)
+            outfile << '\t' << *app << '\n';
+    }
+    outfile.close();
+
+    if (!outfile || rename(tmp_file.c_str(), m_cache_file.c_str()) != 0)
+        remove(tmp_file.c_str());
+}
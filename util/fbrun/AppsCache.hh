@@ -0,0 +1,85 @@
+// AppsCache.hh for fbrun
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef APPSCACHE_HH
+#define APPSCACHE_HH
+
+#include "FbTk/FileUtil.hh"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+/**
+   Executables found in $PATH, for tab completion.
+
+   fbrun does the scan in a helper process, so a slow or hung directory
+   in $PATH never blocks typing.  scanSome() reads a few entries at a
+   time for callers that want to interleave it with other work.
+   What was found is kept in a cache file, a directory is only read again
+   when its modification time changed.
+*/
+class AppsCache {
+public:
+    typedef std::vector<std::string> Apps;
+
+    AppsCache(const std::string &path, const std::string &cache_file);
+    /// saves what an unfinished scan found so far
+    ~AppsCache();
+
+    /// scan a small part of $PATH, @return true if there is more to do
+    bool scanSome();
+    bool done() const { return m_next_dir >= m_dirs.size() && !m_reading; }
+
+    /// @return all executables, sorted, after finishing the scan
+    const Apps &apps();
+
+private:
+    struct DirEntry {
+        DirEntry(): mtime(0) { }
+        time_t mtime;
+        Apps apps;
+    };
+    typedef std::map<std::string, DirEntry> DirMap;
+
+    void startDirectory(const std::string &dir);
+    void finishDirectory();
+    void load();
+    void finishScan();
+    void save(const DirMap &dirs) const;
+
+    std::string m_cache_file;
+    std::vector<std::string> m_dirs; ///< directories of $PATH, in order
+    size_t m_next_dir;
+    DirMap m_cached; ///< what the cache file holds
+    DirMap m_scanned; ///< what this run found
+
+    FbTk::Directory m_dir; ///< directory being read
+    bool m_reading;
+    DirEntry m_current; ///< entry of the directory being read
+
+    bool m_changed; ///< cache file needs to be written
+    bool m_sorted;
+    Apps m_apps;
+};
+
+#endif // APPSCACHE_HH
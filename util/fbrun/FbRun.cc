@@ -20,6 +20,7 @@
 // DEALINGS IN THE SOFTWARE.
 
 #include "FbRun.hh"
+#include "AppsCache.hh"
 
 #include "FbTk/App.hh"
 #include "FbTk/EventManager.hh"
@@ -41,10 +42,13 @@
 #include <X11/Xutil.h>
 #include <X11/cursorfont.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 
 #include <iostream>
 #include <iterator>
-#include <fstream>
 #include <algorithm>
 
 #ifdef _WIN32
@@ -54,10 +58,6 @@
 using std::cerr;
 using std::endl;
 using std::string;
-using std::fstream;
-using std::ifstream;
-using std::ofstream;
-using std::ios;
 
 FbRun::FbRun(int x, int y, size_t width):
     FbTk::TextBox(DefaultScreen(FbTk::App::instance()->display()),
@@ -68,9 +68,13 @@ FbRun::FbRun(int x, int y, size_t width):
     m_bevel(4),
     m_gc(*this),
     m_end(false),
-    m_current_history_item(0),
+    m_current_history_item(static_cast<size_t>(-1)),
     m_last_completion_prefix(""),
-    m_current_apps_item(0),
+    m_current_apps_item(static_cast<size_t>(-1)),
+    m_path_apps_done(false),
+    m_apps_fd(-1),
+    m_apps_pid(0),
+    m_complete_pending(false),
     m_cursor(XCreateFontCursor(FbTk::App::instance()->display(), XC_xterm)) {
 
     setGC(m_gc.gc());
@@ -114,6 +118,11 @@ FbRun::FbRun(int x, int y, size_t width):
 
 FbRun::~FbRun() {
     hide();
+    // a running helper still finishes and writes the cache
+    if (m_apps_fd != -1) {
+        FbTk::FdHandler::instance().unregisterHandler(m_apps_fd);
+        close(m_apps_fd);
+    }
 }
 
 void FbRun::run(const std::string &command) {
@@ -162,78 +171,18 @@ void FbRun::run(const std::string &command) {
     hide(); // hide gui
 
     // save command history to file
-    if (text().size() != 0) { // no need to save empty command
-
-        // don't allow duplicates into the history file, first
-        // look for a duplicate
-        if (m_current_history_item < m_history.size()
-            && text() == m_history[m_current_history_item]) {
-            // m_current_history_item is the duplicate
-        } else {
-            m_current_history_item = 0;
-            for (; m_current_history_item < m_history.size();
-                 ++m_current_history_item) {
-                if (m_history[m_current_history_item] == text())
-                    break;
-            }
-        }
-
-        fstream inoutfile(m_history_file.c_str(), ios::in|ios::out);
-        if (inoutfile) {
-            // now m_current_history_item points at the duplicate, or
-            // at m_history.size() if no duplicate
-            if (m_current_history_item != m_history.size()) {
-                unsigned int i = 0;
-                // read past history items before current
-                for (; inoutfile.good() && i < m_current_history_item; i++)
-                    inoutfile.ignore(1, '\n');
-
-                // write the history items that come after current
-                for (i++; i < m_history.size(); i++)
-                    inoutfile<<m_history[i]<<endl;
-
-            } else {
-                // set put-pointer at end of file
-                inoutfile.seekp(0, ios::end);
-            }
-            // append current command to the file
-            inoutfile<<command<<endl;
-
-        } else
-            cerr<<"FbRun Warning: Can't write command history to file: "<<m_history_file<<endl;
-    }
-
+    if (text().size() != 0) // no need to save empty command
+        m_history.add(command);
 }
 
 bool FbRun::loadHistory(const char *filename) {
     if (filename == 0)
         return false;
-    ifstream infile(filename);
-    if (!infile) {
-        //even though we fail to load file, we should try save to it
-        ofstream outfile(filename);
-        if (outfile) {
-            m_history_file = filename;
-            return true;
-        }
-        return false;
-    }
-    // clear old history and load new one from file
-    m_history.clear();
-    // each line is a command
-    string line;
-    while (!infile.eof()) {
-        getline(infile, line);
-        if (line.size()) // don't add empty lines
-            m_history.push_back(line);
-    }
-    // set no current histor to display
-    m_current_history_item = m_history.size();
-    // set history file
-    m_history_file = filename;
-    return true;
+    // the history is only indexed once it is used
+    return m_history.load(filename);
 }
 
+
 bool FbRun::loadFont(const string &fontname) {
     if (!m_font.load(fontname.c_str()))
         return false;
@@ -325,8 +274,12 @@ void FbRun::keyPressEvent(XKeyEvent &ke) {
         }
     }
     clear();
-    if (!did_tab_complete)
+    if (!did_tab_complete) {
+        m_complete_pending = false;
         m_last_completion_prefix = "";
+        // no completion to cycle through anymore
+        m_current_apps_item = static_cast<size_t>(-1);
+    }
 }
 
 void FbRun::lockPosition(bool size_too) {
@@ -345,7 +298,14 @@ void FbRun::lockPosition(bool size_too) {
     XSetWMNormalHints(m_display, window(), &sh);
 }
 
+void FbRun::initHistoryItem() {
+    // no item yet, start at the end of the history
+    if (m_current_history_item > m_history.size())
+        m_current_history_item = m_history.size();
+}
+
 void FbRun::prevHistoryItem() {
+    initHistoryItem();
     if (m_history.empty() || m_current_history_item == 0) {
         XBell(m_display, 0);
     } else {
@@ -355,6 +315,7 @@ void FbRun::prevHistoryItem() {
 }
 
 void FbRun::nextHistoryItem() {
+    initHistoryItem();
     if (m_current_history_item == m_history.size()) {
         XBell(m_display, 0);
     } else {
@@ -370,6 +331,7 @@ void FbRun::nextHistoryItem() {
 }
 
 void FbRun::firstHistoryItem() {
+    initHistoryItem();
     if (m_history.empty() || m_current_history_item == 0) {
         XBell(m_display, 0);
     } else {
@@ -379,6 +341,7 @@ void FbRun::firstHistoryItem() {
 }
 
 void FbRun::lastHistoryItem() {
+    initHistoryItem();
     // actually one past the end
     if (m_history.empty()) {
         XBell(m_display, 0);
@@ -389,133 +352,195 @@ void FbRun::lastHistoryItem() {
 }
 
 void FbRun::tabCompleteHistory() {
+    initHistoryItem();
     if (m_current_history_item == 0 || m_history.empty() ) {
         XBell(m_display, 0);
     } else {
-        unsigned int nr= 0;
-        unsigned int history_item = m_current_history_item - 1;
         if (m_last_completion_prefix.empty())
             m_last_completion_prefix = text().substr(0, textStartPos() + cursorPosition());
 
-        while (history_item != m_current_history_item && nr++ < m_history.size()) {
-            if (m_history[history_item].find(m_last_completion_prefix) == 0) {
-                m_current_history_item = history_item;
-                setText(FbTk::BiDiString(m_history[m_current_history_item]));
-                cursorEnd();
-                break;
-            }
-            if (history_item == 0) // loop
-                history_item = m_history.size();
-            history_item--;
+        size_t history_item = m_history.findPrefix(m_last_completion_prefix,
+                                                   m_current_history_item);
+        if (history_item == m_history.size()) {
+            XBell(m_display, 0);
+        } else {
+            m_current_history_item = history_item;
+            setText(FbTk::BiDiString(m_history[m_current_history_item]));
+            cursorEnd();
         }
-        if (history_item == m_current_history_item) XBell(m_display, 0);
     }
 }
 
 void FbRun::tabCompleteApps() {
 
-    static bool first_run= true;
     if (m_last_completion_prefix.empty())
         m_last_completion_prefix = text().substr(0, textStartPos() + cursorPosition());
-    string prefix = m_last_completion_prefix;
-    FbTk::Directory dir;
+    const string &prefix = m_last_completion_prefix;
 
-    bool add_dirs= false;
-    bool changed_prefix= false;
+    // paths are completed in their directory, everything else from $PATH
+    bool add_dirs = !prefix.empty() &&
+        string("/.~").find_first_of(prefix[0]) != string::npos;
 
-    // (re)build m_apps-container
-    if (first_run || m_last_completion_prefix != prefix) {
-        first_run= false;
+    const AppsContainer *apps = &m_apps;
+    if (add_dirs) {
+        string dir = prefix.substr(0, prefix.find_last_of("/") + 1);
+        if (dir != m_apps_dir)
+            listDirectory(dir);
+    } else {
+        if (!m_path_apps_done) {
+            // completes once the scan is done, unless the text changes
+            startAppsScan();
+            if (!m_path_apps_done) {
+                m_complete_pending = true;
+                return;
+            }
+        }
+        apps = &m_path_apps;
+    }
 
-        string path;
+    // the apps are sorted, so all completions are next to each other
+    AppsContainer::const_iterator it = std::lower_bound(apps->begin(),
+                                                        apps->end(), prefix);
+    size_t first = it - apps->begin();
+    for (; it != apps->end() && it->compare(0, prefix.size(), prefix) == 0; ++it)
+        continue;
+    size_t last = it - apps->begin();
 
-        if(!prefix.empty() &&
-            string("/.~").find_first_of(prefix[0]) != string::npos) {
-            size_t rseparator= prefix.find_last_of("/");
-            path= prefix.substr(0, rseparator + 1) +  ":";
-            add_dirs= true;
-        } else {
-            char* tmp_path = getenv("PATH");
-            if (tmp_path)
-                path = tmp_path;
-        }
-        m_apps.clear();
-
-        unsigned int l;
-        unsigned int r;
-
-        for(l= 0, r= 0; r < path.size(); r++) {
-            if ((path[r]==':' || r == path.size() - 1) && r - l > 0) {
-                string filename;
-                string fncomplete;
-                dir.open(path.substr(l, r - l).c_str());
-                int n= dir.entries();
-                if (n >= 0) {
-                    while(n--) {
-                        filename= dir.readFilename();
-                        fncomplete= dir.name() +
-                                    (*dir.name().rbegin() != '/' ? "/" : "") +
-                                    filename;
-
-                        // directories in dirmode ?
-                        if (add_dirs && FbTk::FileUtil::isDirectory(fncomplete.c_str()) &&
-                            filename != ".." && filename != ".") {
-                            m_apps.push_back(fncomplete);
-                        // executables in dirmode ?
-                        } else if (add_dirs && FbTk::FileUtil::isRegularFile(fncomplete.c_str()) &&
-                                   FbTk::FileUtil::isExecutable(fncomplete.c_str()) &&
-                                   (prefix == "" ||
-                                    fncomplete.substr(0, prefix.size()) == prefix)) {
-                            m_apps.push_back(fncomplete);
-                        // executables in $PATH ?
-                        } else if (FbTk::FileUtil::isRegularFile(fncomplete.c_str()) &&
-                                   FbTk::FileUtil::isExecutable(fncomplete.c_str()) &&
-                                   (prefix == "" ||
-                                    filename.substr(0, prefix.size()) == prefix)) {
-                            m_apps.push_back(filename);
-                        }
-                    }
-                }
-                l= r + 1;
-                dir.close();
-            }
+    if (first == last) {
+        XBell(m_display, 0);
+        return;
+    }
+
+    size_t apps_item = first;
+    if (m_current_apps_item >= first && m_current_apps_item < last) {
+        // cycle through the completions
+        if (last - first == 1) {
+            XBell(m_display, 0);
+            return;
         }
-        sort(m_apps.begin(), m_apps.end());
-        unique(m_apps.begin(), m_apps.end());
+        apps_item = m_current_apps_item + 1;
+        if (apps_item == last)
+            apps_item = first;
+    }
+
+    m_current_apps_item = apps_item;
+    const string &completion = (*apps)[apps_item];
+    if (add_dirs && FbTk::FileUtil::isDirectory(completion.c_str()))
+        setText(completion + "/");
+    else
+        setText(completion);
+    cursorEnd();
+}
+
+void FbRun::listDirectory(const string &dir) {
+    m_apps.clear();
+    m_apps_dir = dir;
+
+    FbTk::Directory directory;
+    if (dir.empty() || !directory.open(dir.c_str()))
+        return;
 
-        m_last_completion_prefix = prefix;
-        changed_prefix= true;
-        m_current_apps_item= 0;
+    struct dirent *ent;
+    while ((ent = directory.read()) != 0) {
+        string filename = ent->d_name;
+        if (filename == "." || filename == "..")
+            continue;
+
+        // directories and executables
+        string fncomplete = dir + filename;
+        struct stat buf;
+        if (stat(fncomplete.c_str(), &buf) != 0)
+            continue;
+        if (S_ISDIR(buf.st_mode) ||
+            (S_ISREG(buf.st_mode) &&
+             (buf.st_mode & (S_IXUSR | S_IXGRP | S_IXOTH))))
+            m_apps.push_back(fncomplete);
     }
 
-    if (m_apps.empty() ) {
-      XBell(m_display, 0);
-    } else {
-        size_t apps_item = m_current_apps_item + (changed_prefix ? 0 : 1);
-        bool loop= false;
+    sort(m_apps.begin(), m_apps.end());
+}
 
-        while (true) {
-            if (apps_item >= m_apps.size() ) {
-                loop = true;
-                apps_item = 0;
-            }
+void FbRun::startAppsScan() {
+    if (m_apps_pid != 0 || m_path_apps_done)
+        return;
 
-            if ((!changed_prefix || loop) && apps_item == m_current_apps_item) {
-                break;
+    const char *path = getenv("PATH");
+    if (path == 0)
+        path = "";
+
+#ifdef HAVE_FORK
+    // a slow or hung directory in $PATH only blocks the helper,
+    // typing goes on while it reads
+    int fds[2];
+    if (pipe(fds) == 0) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            AppsCache cache(path, m_apps_cache_file);
+            const AppsCache::Apps &apps = cache.apps();
+            string out;
+            for (size_t i = 0; i < apps.size(); ++i) {
+                out += apps[i];
+                out += '\n';
             }
-            if (m_apps[apps_item].find(prefix) == 0) {
-                m_current_apps_item = apps_item;
-                if (add_dirs && FbTk::FileUtil::isDirectory(m_apps[m_current_apps_item].c_str()))
-                    setText(m_apps[m_current_apps_item] +  "/");
-                else
-                    setText(m_apps[m_current_apps_item]);
-                cursorEnd();
-                break;
+            const char *data = out.data();
+            size_t left = out.size();
+            ssize_t len;
+            while (left > 0 && (len = write(fds[1], data, left)) > 0) {
+                data += len;
+                left -= len;
             }
-            apps_item++;
+            // don't run any destructors, they belong to the parent
+            _exit(EXIT_SUCCESS);
         }
-        if (!changed_prefix && apps_item == m_current_apps_item)
-            XBell(m_display, 0);
+
+        close(fds[1]);
+        if (pid != -1) {
+            fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+            fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+            m_apps_fd = fds[0];
+            m_apps_pid = pid;
+            FbTk::FdHandler::instance().registerHandler(m_apps_fd, this);
+            return;
+        }
+        close(fds[0]);
+    }
+#endif // HAVE_FORK
+
+    // no helper, so scan right here
+    AppsCache cache(path, m_apps_cache_file);
+    m_path_apps = cache.apps();
+    m_path_apps_done = true;
+}
+
+void FbRun::handleFdEvent(int fd) {
+    char buf[4096];
+    ssize_t len;
+    while ((len = read(fd, buf, sizeof(buf))) > 0)
+        m_apps_buffer.append(buf, len);
+    if (len == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return;
+
+    // the helper is done, or died
+    FbTk::FdHandler::instance().unregisterHandler(fd);
+    close(fd);
+    m_apps_fd = -1;
+    waitpid(m_apps_pid, 0, 0);
+    m_apps_pid = 0;
+
+    // sorted by the helper already
+    string::size_type start = 0, end;
+    while ((end = m_apps_buffer.find('\n', start)) != string::npos) {
+        m_path_apps.push_back(m_apps_buffer.substr(start, end - start));
+        start = end + 1;
+    }
+    m_apps_buffer.clear();
+    m_path_apps_done = true;
+
+    if (m_complete_pending) {
+        m_complete_pending = false;
+        tabCompleteApps();
+        clear();
     }
 }
 
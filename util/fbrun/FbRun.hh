@@ -28,14 +28,18 @@
 #include "FbTk/TextBox.hh"
 #include "FbTk/GContext.hh"
 #include "FbTk/FbPixmap.hh"
+#include "FbTk/FdHandler.hh"
+
+#include "History.hh"
 
 #include <string>
 #include <vector>
+#include <sys/types.h>
 
 /**
    Creates and managed a run window
 */
-class FbRun: public FbTk::TextBox {
+class FbRun: public FbTk::TextBox, private FbTk::FdEventHandler {
 public:
     FbRun(int x = 0, int y = 0, size_t width = 200);
     ~FbRun();
@@ -58,6 +62,8 @@ public:
        @return true on success, else false
     */
     bool loadHistory(const char *filename);
+    /// cache file for the executables in $PATH, read on the first Tab
+    void setAppsCacheFile(const std::string &filename) { m_apps_cache_file = filename; }
     /**
        @name events
     */
@@ -69,6 +75,7 @@ public:
     void lockPosition(bool size_too);
 
 private:
+    void initHistoryItem();
     void nextHistoryItem();
     void prevHistoryItem();
     void drawString(int x, int y, const char *text, size_t len);
@@ -83,6 +90,10 @@ private:
     void lastHistoryItem();
     void tabCompleteHistory();
     void tabCompleteApps();
+    void listDirectory(const std::string &dir);
+    void startAppsScan();
+    /// reads the executables the scan helper found
+    void handleFdEvent(int fd);
 
     bool m_print; ///< the input should be printed to stdout rather than run
     FbTk::Font m_font; ///< font used to draw command text
@@ -90,15 +101,23 @@ private:
     int m_bevel;
     FbTk::GContext m_gc; ///< graphic context
     bool m_end; ///< marks when this object is done
-    std::vector<std::string> m_history; ///< history list of commands
-    std::string m_history_file; ///< holds filename for command history file
+    History m_history; ///< history list of commands
     size_t m_current_history_item; ///< holds current position in command history
     std::string m_last_completion_prefix; ///< last prefix we completed on
     
     typedef std::vector<std::string> AppsContainer;
     typedef AppsContainer::iterator AppsContainerIt;
-    AppsContainer m_apps; ///< holds all apps in $PATH
+    AppsContainer m_apps; ///< holds the contents of m_apps_dir
+    std::string m_apps_dir; ///< directory we complete paths in
     size_t m_current_apps_item; ///< holds current position in apps-history
+
+    std::string m_apps_cache_file; ///< cache of the executables in $PATH
+    AppsContainer m_path_apps; ///< executables in $PATH, sorted
+    bool m_path_apps_done; ///< m_path_apps is complete
+    int m_apps_fd; ///< pipe from the scan helper, or -1
+    pid_t m_apps_pid; ///< scan helper, or 0
+    std::string m_apps_buffer; ///< what the scan helper sent so far
+    bool m_complete_pending; ///< Tab was pressed before the scan finished
     
     Cursor m_cursor;
 
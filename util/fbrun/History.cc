@@ -0,0 +1,276 @@
+// History.cc for fbrun
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "History.hh"
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif // HAVE_MMAP
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using std::string;
+
+struct History::EntryLess {
+    bool operator()(const Entry &a, const Entry &b) const {
+        int cmp = memcmp(a.text, b.text, std::min(a.len, b.len));
+        return cmp < 0 || (cmp == 0 && a.len < b.len);
+    }
+};
+
+/// compares entries by their index
+struct History::IndexLess {
+    IndexLess(const std::vector<Entry> &e): entries(e) { }
+    bool operator()(size_t a, size_t b) const {
+        return less(entries[a], entries[b]);
+    }
+    const std::vector<Entry> &entries;
+    EntryLess less;
+};
+
+History::History():
+    m_data(0),
+    m_size(0),
+    m_mapped(false),
+    m_indexed(false),
+    m_lines(0) {
+}
+
+History::~History() {
+    unload();
+}
+
+bool History::load(const string &filename) {
+    unload();
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        // even though we fail to load file, we should try save to it
+        std::ofstream outfile(filename.c_str());
+        if (!outfile)
+            return false;
+        m_filename = filename;
+        return true;
+    }
+
+    m_filename = filename;
+
+    struct stat buf;
+    if (fstat(fd, &buf) == 0 && buf.st_size > 0) {
+        m_size = buf.st_size;
+#ifdef HAVE_MMAP
+        void *data = mmap(0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = static_cast<const char *>(data);
+            m_mapped = true;
+        }
+#endif // HAVE_MMAP
+        if (!m_mapped) {
+            m_buffer.resize(m_size);
+            ssize_t got = read(fd, &m_buffer[0], m_size);
+            m_size = got > 0 ? got : 0;
+            m_data = &m_buffer[0];
+        }
+    }
+
+    close(fd);
+    return true;
+}
+
+void History::unload() {
+#ifdef HAVE_MMAP
+    if (m_mapped)
+        munmap(const_cast<char *>(m_data), m_size);
+#endif // HAVE_MMAP
+    m_data = 0;
+    m_size = 0;
+    m_mapped = false;
+    m_buffer.clear();
+    m_added.clear();
+    m_indexed = false;
+    m_lines = 0;
+    m_entries.clear();
+    m_sorted.clear();
+}
+
+size_t History::size() const {
+    index();
+    return m_entries.size();
+}
+
+string History::operator[](size_t i) const {
+    index();
+    return string(m_entries[i].text, m_entries[i].len);
+}
+
+size_t History::findPrefix(const string &prefix, size_t before) const {
+    index();
+
+    Entry key = { prefix.data(), prefix.size() };
+    IndexLess less(m_entries);
+    size_t older = m_entries.size(), newer = m_entries.size();
+
+    // all commands starting with prefix are next to each other in m_sorted
+    std::vector<size_t>::const_iterator it = m_sorted.begin();
+    size_t count = m_sorted.size();
+    while (count > 0) {
+        size_t step = count / 2;
+        if (less.less(m_entries[*(it + step)], key)) {
+            it += step + 1;
+            count -= step + 1;
+        } else
+            count = step;
+    }
+
+    for (; it != m_sorted.end(); ++it) {
+        const Entry &entry = m_entries[*it];
+        if (entry.len < prefix.size() ||
+            memcmp(entry.text, prefix.data(), prefix.size()) != 0)
+            break;
+        if (*it < before && (older == m_entries.size() || *it > older))
+            older = *it;
+        else if (*it > before && (newer == m_entries.size() || *it > newer))
+            newer = *it;
+    }
+
+    return older != m_entries.size() ? older : newer;
+}
+
+void History::add(const string &command) {
+    if (command.empty() || command.find('\n') != string::npos)
+        return;
+
+    index();
+
+    // the command becomes the newest one
+    Entry key = { command.data(), command.size() };
+    IndexLess less(m_entries);
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        if (!less.less(m_entries[i], key) && !less.less(key, m_entries[i])) {
+            m_entries.erase(m_entries.begin() + i);
+            break;
+        }
+    }
+    m_added.push_back(command);
+    Entry entry = { m_added.back().data(), m_added.back().size() };
+    m_entries.push_back(entry);
+
+    m_sorted.resize(m_entries.size());
+    for (size_t i = 0; i < m_sorted.size(); ++i)
+        m_sorted[i] = i;
+    std::sort(m_sorted.begin(), m_sorted.end(), less);
+
+    m_lines++;
+    if (m_lines > 2 * m_entries.size() + 64 && compact())
+        return;
+
+    std::ofstream outfile(m_filename.c_str(), std::ios::out | std::ios::app);
+    if (!outfile)
+        return;
+    // don't glue the command to an unfinished last line
+    if (m_added.size() == 1 && m_size > 0 && m_data[m_size - 1] != '\n')
+        outfile << '\n';
+    outfile << command << '\n';
+}
+
+void History::index() const {
+    if (m_indexed)
+        return;
+    m_indexed = true;
+
+    // every line of the file, in order
+    std::vector<Entry> lines;
+    const char *pos = m_data, *end = m_data + m_size;
+    while (pos < end) {
+        const char *eol = static_cast<const char *>(memchr(pos, '\n', end - pos));
+        if (eol == 0)
+            eol = end;
+        if (eol > pos) { // don't add empty lines
+            Entry entry = { pos, static_cast<size_t>(eol - pos) };
+            lines.push_back(entry);
+        }
+        pos = eol + 1;
+    }
+    m_lines = lines.size();
+
+    // sorting keeps copies of a command together, in file order,
+    // the last one of them is the one that counts
+    std::vector<size_t> order(lines.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    IndexLess less(lines);
+    std::stable_sort(order.begin(), order.end(), less);
+
+    std::vector<bool> keep(lines.size(), false);
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i + 1 == order.size() || less(order[i], order[i + 1]))
+            keep[order[i]] = true;
+    }
+
+    std::vector<size_t> new_index(lines.size());
+    m_entries.clear();
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (keep[i]) {
+            new_index[i] = m_entries.size();
+            m_entries.push_back(lines[i]);
+        }
+    }
+
+    m_sorted.clear();
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (keep[order[i]])
+            m_sorted.push_back(new_index[order[i]]);
+    }
+}
+
+bool History::compact() {
+    // write a new file and move it over the old one, the entries
+    // still point into the mapping of the old one
+    string tmp_file = m_filename + ".tmp";
+    std::ofstream outfile(tmp_file.c_str());
+    if (!outfile)
+        return false;
+
+    std::vector<Entry>::const_iterator it = m_entries.begin();
+    for (; it != m_entries.end(); ++it) {
+        outfile.write(it->text, it->len);
+        outfile << '\n';
+    }
+    outfile.close();
+
+    if (!outfile || rename(tmp_file.c_str(), m_filename.c_str()) != 0) {
+        remove(tmp_file.c_str());
+        return false;
+    }
+    m_lines = m_entries.size();
+    return true;
+}
@@ -0,0 +1,87 @@
+// History.hh for fbrun
+// Copyright (c) 2011 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef HISTORY_HH
+#define HISTORY_HH
+
+#include <list>
+#include <string>
+#include <vector>
+
+/**
+   Command history of fbrun.
+
+   The history file is mapped into memory and only indexed when the
+   history is first used, so a long history doesn't slow down startup.
+   New commands are appended to the file, older copies of a command are
+   dropped when reading it. The file is rewritten without them once they
+   make up most of it.
+*/
+class History {
+public:
+    History();
+    ~History();
+
+    /// maps the history file, creating it if needed
+    bool load(const std::string &filename);
+
+    /// @return number of different commands
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    /// @return command number i, oldest first
+    std::string operator[](size_t i) const;
+
+    /**
+       finds the newest command starting with prefix that is older than
+       'before', or else the newest one newer than it
+       @return index of the command, size() if there is none
+    */
+    size_t findPrefix(const std::string &prefix, size_t before) const;
+
+    /// makes command the newest one and appends it to the file
+    void add(const std::string &command);
+
+private:
+    struct Entry {
+        const char *text;
+        size_t len;
+    };
+    struct EntryLess;
+    struct IndexLess;
+
+    void unload();
+    void index() const;
+    bool compact();
+
+    std::string m_filename;
+    const char *m_data; ///< contents of the file
+    size_t m_size;
+    bool m_mapped;
+    std::vector<char> m_buffer; ///< contents, if it couldn't be mapped
+    std::list<std::string> m_added; ///< commands added since loading
+
+    mutable bool m_indexed;
+    mutable size_t m_lines; ///< commands in the file, with duplicates
+    mutable std::vector<Entry> m_entries; ///< oldest first, no duplicates
+    mutable std::vector<size_t> m_sorted; ///< m_entries sorted by text
+};
+
+#endif // HISTORY_HH
@@ -23,6 +23,8 @@
 #include "FbTk/App.hh"
 #include "FbTk/StringUtil.hh"
 #include "FbTk/Color.hh"
+#include "FbTk/EventManager.hh"
+#include "FbTk/Timer.hh"
 
 #ifdef XINERAMA
 extern  "C" {
@@ -65,6 +67,7 @@ void showUsage(const char *progname) {
         "   -bg [color name]            Background color"<<endl<<
         "   -na                         Disable antialias"<<endl<<
         "   -hf [history file]          History file to load (default ~/.fluxbox/fbrun_history)"<<endl<<
+        "   -cf [cache file]            Completion cache to use (default ~/.fluxbox/fbrun_cache)"<<endl<<
         "   -help                       Show this help"<<endl<<endl<<
         "Example: fbrun -fg black -bg white -text xterm -title \"run xterm\""<<endl;
 }
@@ -84,6 +87,7 @@ int main(int argc, char **argv) {
     string background("white");   // text background color
     string display_name; // name of the display connection
     string history_file("~/.fluxbox/fbrun_history"); // command history file
+    string cache_file("~/.fluxbox/fbrun_cache"); // $PATH completion cache
     // parse arguments
     for (int i=1; i<argc; i++) {
         string arg = argv[i];
@@ -118,6 +122,8 @@ int main(int argc, char **argv) {
             antialias = false;
         } else if (strcmp(argv[i], "-hf") == 0 && i+1 < argc) {
             history_file = argv[++i];
+        } else if (strcmp(argv[i], "-cf") == 0 && i+1 < argc) {
+            cache_file = argv[++i];
         } else if (arg == "-h" || arg == "-help" || arg == "--help") {
             showUsage(argv[0]);
             exit(0);
@@ -161,6 +167,8 @@ int main(int argc, char **argv) {
         if (!fbrun.loadHistory(expanded_filename.c_str()))
             cerr<<"FbRun Warning: Failed to load history file: "<<expanded_filename<<endl;
 
+        fbrun.setAppsCacheFile(FbTk::StringUtil::expandFilename(cache_file));
+
         fbrun.setTitle(title);
         fbrun.setText(text);
 
@@ -225,7 +233,18 @@ int main(int argc, char **argv) {
 
         fbrun.show();
 
-        application.eventLoop();
+
+        // the $PATH scan for tab completion reports through a pipe
+        Display *disp = application.display();
+        XEvent event;
+        while (!fbrun.end()) {
+            if (XPending(disp) == 0) {
+                FbTk::Timer::updateTimers(ConnectionNumber(disp));
+                continue;
+            }
+            XNextEvent(disp, &event);
+            FbTk::EventManager::instance()->handleEvent(event);
+        }
 
     } catch (string & errstr) {
         cerr<<"Error: "<<errstr<<endl;
@@ -23,6 +23,8 @@
 #include "../src/FbTk/I18n.hh"
 #include "../src/FbTk/ImageControl.hh"
 #include "../src/FbTk/Texture.hh"
+#include "../src/FbTk/TextureRender.hh"
+#include "../src/FbTk/Stats.hh"
 #include "../src/FbTk/GContext.hh"
 #include "../src/FbRootWindow.hh"
 
@@ -48,6 +50,7 @@
   #include <stdio.h>
 #endif
 #include <iostream>
+#include <sys/time.h>
 
 using std::cout;
 using std::cerr;
@@ -58,6 +61,13 @@ inline int getRootDepth(const FbTk::FbWindow& w) {
     return (w.depth() == 32 ? 24 : w.depth());
 }
 
+inline long usecSince(const timeval &start) {
+    timeval now;
+    gettimeofday(&now, 0);
+    return (now.tv_sec - start.tv_sec) * 1000000L +
+           (now.tv_usec - start.tv_usec);
+}
+
 
 fbsetroot::fbsetroot(int argc, char **argv, char *dpy_name)
     : FbTk::App(dpy_name), m_app_name(argv[0]) {
@@ -66,7 +76,7 @@ fbsetroot::fbsetroot(int argc, char **argv, char *dpy_name)
     screen = DefaultScreen(FbTk::App::instance()->display());
     grad = fore = back = (char *) 0;
 
-    bool mod = false, sol = false, grd = false;
+    bool mod = false, sol = false, grd = false, benchmark = false;
     int mod_x = 0, mod_y = 0, i = 1;
 
     img_ctrl = new FbTk::ImageControl(screen);
@@ -114,6 +124,9 @@ fbsetroot::fbsetroot(int argc, char **argv, char *dpy_name)
             grad = argv[i];
             grd = true;
 
+        } else if (arg == "-benchmark" || arg == "--benchmark") {
+            benchmark = true;
+
         } else if (arg == "-display" || arg == "--display") {
             // -display passed through tests earlier... we just skip it now
             i++;
@@ -131,6 +144,12 @@ fbsetroot::fbsetroot(int argc, char **argv, char *dpy_name)
         exit(2);
     }
 
+    timeval start;
+    if (benchmark) {
+        FbTk::Stats::enable();
+        gettimeofday(&start, 0);
+    }
+
     if (sol && fore)
         solid();
     else if (mod && mod_x && mod_y && fore && back)
@@ -140,6 +159,15 @@ fbsetroot::fbsetroot(int argc, char **argv, char *dpy_name)
     else
         usage();
 
+    if (benchmark) {
+        // what the server still has to do counts as upload
+        long upload = FbTk::TextureRender::uploadStat().totalUsec();
+        long render = usecSince(start) - upload;
+        XSync(display(), False);
+        upload = usecSince(start) - render;
+        printf("render: %.1f ms, upload: %.1f ms\n",
+               render / 1000.0, upload / 1000.0);
+    }
 }
 
 
@@ -311,9 +339,9 @@ void fbsetroot::modula(int x, int y) {
  draws pixmaps with a fluxbox texure
 */
 void fbsetroot::gradient() {
-    // using temporaray pixmap and then copying it to background pixmap, as it'll
-    // get crashed somewhere on the way causing apps like XChat chrashing
-    // as the pixmap has been destroyed
+    // the pixmap is rendered outside of the image cache, a cached one
+    // would get destroyed on the way causing apps like XChat to crash.
+    // it only needs a copy if the depth differs from the root window
     Pixmap tmp;
     // we must insert gradient text
     string texture_value = grad ? grad : "solid";
@@ -335,28 +363,28 @@ void fbsetroot::gradient() {
     if (! texture.colorTo().isAllocated())
         texture.colorTo().setPixel(BlackPixel(display(), screen));
 
-    tmp = img_ctrl->renderImage(root.width(), root.height(), texture);
-
-    pixmap = new Pixmap(XCreatePixmap(display(),
-                                      root.window(),
-                                      root.width(), root.height(),
-                                      getRootDepth(root)));
-
-
-    XCopyArea(display(), tmp, *pixmap, gc.gc(), 0, 0,
-              root.width(), root.height(),
-              0, 0);
+    FbTk::TextureRender renderer(*img_ctrl, root.width(), root.height());
+    tmp = renderer.render(texture);
+
+    if (img_ctrl->depth() == getRootDepth(root)) {
+        pixmap = new Pixmap(tmp);
+    } else {
+        pixmap = new Pixmap(XCreatePixmap(display(),
+                                          root.window(),
+                                          root.width(), root.height(),
+                                          getRootDepth(root)));
+
+        XCopyArea(display(), tmp, *pixmap, gc.gc(), 0, 0,
+                  root.width(), root.height(),
+                  0, 0);
+        XFreePixmap(display(), tmp);
+    }
 
     setRootAtoms(*pixmap, screen);
 
     root.setBackgroundPixmap(*pixmap);
     root.clear();
 
-    if (! (root.visual()->c_class & 1)) {
-        img_ctrl->removeImage(tmp);
-        img_ctrl->cleanCache();
-    }
-
 }
 
 /**
@@ -376,6 +404,7 @@ void fbsetroot::usage(int exit_code) {
                   "  -from <color>            gradient start color\n"
                   "  -to <color>              gradient end color\n\n"
                   "  -solid <color>           solid color\n\n"
+                  "  -benchmark               print render and upload times\n"
                   "  -help                    print this help text and exit\n",
                   "fbsetroot usage options") << endl;
     exit(exit_code);
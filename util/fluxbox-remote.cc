@@ -21,10 +21,16 @@
 
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <string>
+
 bool g_gotError;
 static int HandleIPCError(Display *disp, XErrorEvent*ptr)
 {
@@ -33,24 +39,129 @@ static int HandleIPCError(Display *disp, XErrorEvent*ptr)
 	return( 0 );
 }
 
-int main(int argc, char **argv) {
+// connect to the socket fluxbox listens on, returns -1 on failure
+static int connectSocket(const char *path) {
+    sockaddr_un addr;
+    if (!path || !*path || strlen(path) >= sizeof(addr.sun_path))
+        return -1;
 
-    if (argc <= 1) {
-        printf("fluxbox-remote <fluxbox-command>\n");
-        return EXIT_SUCCESS;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1)
+        return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if (connect(fd, (sockaddr *) &addr, sizeof(addr)) == -1) {
+        close(fd);
+        return -1;
     }
+    return fd;
+}
 
-    Display *disp = XOpenDisplay(NULL);
-    if (!disp) {
-        perror("error, can't open display.");
-        return EXIT_FAILURE;
+// "host:number.screen" without the screen, as fluxbox names its socket
+static std::string displayKey(std::string name) {
+    for (std::string::size_type i = 0; i < name.size(); ++i) {
+        if (name[i] == '/')
+            name[i] = '_';
+    }
+    std::string::size_type colon = name.rfind(':');
+    if (colon != std::string::npos) {
+        std::string::size_type dot = name.find('.', colon);
+        if (dot != std::string::npos)
+            name.erase(dot);
+    }
+    return name;
+}
+
+// whether the socket from FLUXBOX_SOCKET belongs to the display we talk to,
+// it is inherited by everything fluxbox starts, even if DISPLAY changes
+static bool socketForDisplay(const char *path, const char *display) {
+    if (!path || !display)
+        return false;
+
+    static const std::string prefix("fluxbox-"), suffix(".socket");
+    std::string name(path);
+    std::string::size_type slash = name.rfind('/');
+    if (slash != std::string::npos)
+        name.erase(0, slash + 1);
+    if (name.size() <= prefix.size() + suffix.size() ||
+        name.compare(0, prefix.size(), prefix) != 0 ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+        return false;
+
+    name = name.substr(prefix.size(),
+                       name.size() - prefix.size() - suffix.size());
+    // sockets in a shared home directory carry the host name
+    std::string::size_type at = name.rfind('@');
+    if (at != std::string::npos)
+        name.erase(at);
+    return displayKey(name) == displayKey(display);
+}
+
+// ask the root window where the socket is
+static int connectSocket(Display *disp) {
+    Atom socket_atom = XInternAtom(disp, "_FLUXBOX_SOCKET", True);
+    if (socket_atom == None)
+        return -1;
+
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    unsigned char *data = 0;
+    int fd = -1;
+    if (XGetWindowProperty(disp, DefaultRootWindow(disp), socket_atom,
+                           0l, 1024l, False, XA_STRING, &type, &format,
+                           &nitems, &bytes_after, &data) == Success && data) {
+        fd = connectSocket((const char *) data);
+        XFree(data);
     }
+    return fd;
+}
 
+// send all commands at once, then collect one reply per command
+static int sendCommands(int fd, const std::string &commands) {
+    const char *data = commands.data();
+    size_t left = commands.size();
+    while (left > 0) {
+        ssize_t len = write(fd, data, left);
+        if (len <= 0) {
+            perror("error, can't talk to fluxbox");
+            return EXIT_FAILURE;
+        }
+        data += len;
+        left -= len;
+    }
+    shutdown(fd, SHUT_WR);
+
+    int ret = EXIT_SUCCESS;
+    std::string reply;
+    char buf[4096];
+    ssize_t len;
+    while ((len = read(fd, buf, sizeof(buf))) > 0)
+        reply.append(buf, len);
+
+    std::string::size_type start = 0, end;
+    while ((end = reply.find('\n', start)) != std::string::npos) {
+        std::string line = reply.substr(start, end - start);
+        start = end + 1;
+        if (line.compare(0, 3, "ok ") == 0) {
+            // the answer to a query
+            printf("%s\n", line.c_str() + 3);
+        } else if (line != "ok") {
+            fprintf(stderr, "%s\n", line.c_str());
+            ret = EXIT_FAILURE;
+        }
+    }
+
+    return ret;
+}
+
+// the old way: hand the command to fluxbox via the _FLUXBOX_ACTION property
+static int sendProperty(Display *disp, const std::string &command) {
     Atom fbcmd_atom = XInternAtom(disp, "_FLUXBOX_ACTION", False);
     Window root = DefaultRootWindow(disp);
 
-    char *str = argv[1];
-
     typedef int (*x_error_handler_t)(Display*,XErrorEvent*);
 
     // assign the custom handler, clear the flag, sync the data, then check it for success/failure
@@ -58,13 +169,68 @@ int main(int argc, char **argv) {
     g_gotError=false;
     XChangeProperty(disp, root, fbcmd_atom,
                               XA_STRING, 8, PropModeReplace,
-                              (unsigned char *) str, strlen(str));
+                              (unsigned char *) command.c_str(), command.size());
     XSync(disp,False);
     int ret=(g_gotError?EXIT_FAILURE:EXIT_SUCCESS);
     XSetErrorHandler(handler);
 
+    return ret;
+}
+
+int main(int argc, char **argv) {
+
+    if (argc <= 1) {
+        printf("fluxbox-remote <fluxbox-command>\n"
+               "fluxbox-remote -   (read commands from stdin, one per line)\n");
+        return EXIT_SUCCESS;
+    }
+
+    std::string commands;
+    if (strcmp(argv[1], "-") == 0) {
+        char buf[4096];
+        size_t len;
+        while ((len = fread(buf, 1, sizeof(buf), stdin)) > 0)
+            commands.append(buf, len);
+    } else
+        commands = argv[1];
+
+    if (commands.empty() || commands[commands.size() - 1] != '\n')
+        commands += '\n';
+
+    // the socket is much cheaper than a round trip through the X server,
+    // and it tells us whether the commands actually worked
+    int fd = -1;
+    const char *socket_path = getenv("FLUXBOX_SOCKET");
+    if (socketForDisplay(socket_path, getenv("DISPLAY")))
+        fd = connectSocket(socket_path);
+    if (fd != -1) {
+        int ret = sendCommands(fd, commands);
+        close(fd);
+        return ret;
+    }
+
+    Display *disp = XOpenDisplay(NULL);
+    if (!disp) {
+        perror("error, can't open display.");
+        return EXIT_FAILURE;
+    }
+
+    int ret = EXIT_SUCCESS;
+    fd = connectSocket(disp);
+    if (fd != -1) {
+        ret = sendCommands(fd, commands);
+        close(fd);
+    } else {
+        std::string::size_type start = 0, end;
+        while ((end = commands.find('\n', start)) != std::string::npos) {
+            std::string line = commands.substr(start, end - start);
+            start = end + 1;
+            if (!line.empty() && sendProperty(disp, line) != EXIT_SUCCESS)
+                ret = EXIT_FAILURE;
+        }
+    }
+
     XCloseDisplay(disp);
 
     return ret;
 }
-